@@ -0,0 +1,49 @@
+#include "BinaryProtocol.h"
+
+uint8_t BinProto_payloadLength(uint8_t type) {
+    switch (BinMsgType(type)) {
+        case BinMsgType::MOTION_LR8:
+        case BinMsgType::MOTION_TS8:  return 2;
+        case BinMsgType::MOTION_LR16:
+        case BinMsgType::MOTION_TS16: return 4;
+    }
+    return 0;
+}
+
+uint8_t BinProto_frameLength(uint8_t type) {
+    uint8_t payload = BinProto_payloadLength(type);
+    return payload ? uint8_t(BIN_HEADER_LEN + payload + 1) : 0;
+}
+
+uint8_t BinProto_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0x00;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? uint8_t((crc << 1) ^ 0x07) : uint8_t(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint8_t BinProto_encode(BinMsgType type, uint8_t seq, int a, int b, uint8_t *out) {
+    uint8_t len = BinProto_frameLength(uint8_t(type));
+    if (len == 0) return 0;
+
+    out[0] = BIN_SYNC;
+    out[1] = uint8_t(type);
+    out[2] = seq;
+    if (BinProto_payloadLength(uint8_t(type)) == 2) {
+        out[3] = uint8_t(int8_t(a));
+        out[4] = uint8_t(int8_t(b));
+    } else {
+        uint16_t ua = uint16_t(int16_t(a));
+        uint16_t ub = uint16_t(int16_t(b));
+        out[3] = uint8_t(ua);
+        out[4] = uint8_t(ua >> 8);
+        out[5] = uint8_t(ub);
+        out[6] = uint8_t(ub >> 8);
+    }
+    out[len - 1] = BinProto_crc8(out + 1, len - 2);
+    return len;
+}
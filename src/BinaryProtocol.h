@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Compact framed binary command protocol, auto-detected next to the ASCII
+// commands. The sync byte never occurs in the text protocol.
+//
+//   [SYNC][TYPE][SEQ][payload ...][CRC8]
+//
+// CRC-8 (poly 0x07, init 0x00) covers TYPE, SEQ and payload.
+// Multi-byte payload values are little-endian, signed.
+
+constexpr uint8_t BIN_SYNC         = 0xA5;
+constexpr uint8_t BIN_HEADER_LEN   = 3;    // SYNC, TYPE, SEQ
+constexpr uint8_t BIN_MAX_FRAME_LEN = 8;
+
+enum class BinMsgType : uint8_t {
+    MOTION_LR8  = 0x01,   // int8  left, right      (-127..127)
+    MOTION_LR16 = 0x02,   // int16 left, right      (-32767..32767)
+    MOTION_TS8  = 0x03,   // int8  throttle, steer  (-127..127)
+    MOTION_TS16 = 0x04    // int16 throttle, steer  (-32767..32767)
+};
+
+// Payload length for a message type, 0 if the type is unknown
+uint8_t BinProto_payloadLength(uint8_t type);
+
+// Full frame length (header + payload + CRC), 0 if the type is unknown
+uint8_t BinProto_frameLength(uint8_t type);
+
+uint8_t BinProto_crc8(const uint8_t *data, size_t len);
+
+// Writes a complete frame for two signed values; returns its length.
+// Used by host tools and the simulator to generate traffic.
+uint8_t BinProto_encode(BinMsgType type, uint8_t seq, int a, int b, uint8_t *out);
@@ -0,0 +1,101 @@
+#include "BlackBox.h"
+#include <atomic>
+
+static BlackBoxSample ring[BLACKBOX_SAMPLES];
+
+// head counts samples ever written; the writer publishes with release after
+// filling ring[head % N] and never writes once it has seen frozen
+static std::atomic<uint32_t> head(0);
+static std::atomic<bool> frozen(false);
+static std::atomic<bool> clearRequested(false);
+static std::atomic<uint8_t> reason(uint8_t(BlackBoxReason::NONE));
+static uint16_t postTriggerLeft = 0;        // control task only
+
+void BlackBox_init() {
+    head.store(0, std::memory_order_relaxed);
+    frozen.store(false, std::memory_order_relaxed);
+    clearRequested.store(false, std::memory_order_relaxed);
+    reason.store(uint8_t(BlackBoxReason::NONE), std::memory_order_relaxed);
+    postTriggerLeft = 0;
+}
+
+void BlackBox_record(const BlackBoxSample &s) {
+    if (clearRequested.exchange(false, std::memory_order_relaxed)) {
+        head.store(0, std::memory_order_relaxed);
+        reason.store(uint8_t(BlackBoxReason::NONE), std::memory_order_relaxed);
+        postTriggerLeft = 0;
+        frozen.store(false, std::memory_order_seq_cst);
+    }
+    if (frozen.load(std::memory_order_seq_cst)) return;
+
+    uint32_t h = head.load(std::memory_order_relaxed);
+    ring[h % BLACKBOX_SAMPLES] = s;
+    head.store(h + 1, std::memory_order_release);
+
+    if (postTriggerLeft > 0 && --postTriggerLeft == 0) {
+        frozen.store(true, std::memory_order_seq_cst);
+    }
+}
+
+void BlackBox_trigger() {
+    if (frozen.load(std::memory_order_relaxed) || postTriggerLeft > 0) return;   // keep the first event
+    reason.store(uint8_t(BlackBoxReason::FAILSAFE), std::memory_order_relaxed);
+    postTriggerLeft = BLACKBOX_POST_TRIGGER;
+}
+
+void BlackBox_freeze() {
+    if (frozen.exchange(true, std::memory_order_seq_cst)) return;
+    reason.store(uint8_t(BlackBoxReason::COMMAND), std::memory_order_relaxed);
+}
+
+void BlackBox_clear() {
+    clearRequested.store(true, std::memory_order_relaxed);
+}
+
+// A write that was already in flight when BlackBox_freeze() ran can still
+// land in the oldest slot, so at most N-1 samples are readable
+static uint32_t readableCount(uint32_t h) {
+    return h < BLACKBOX_SAMPLES ? h : BLACKBOX_SAMPLES - 1;
+}
+
+static const __FlashStringHelper *reasonName(uint8_t r) {
+    switch (BlackBoxReason(r)) {
+        case BlackBoxReason::NONE:     return F("-");
+        case BlackBoxReason::FAILSAFE: return F("FAILSAFE");
+        case BlackBoxReason::COMMAND:  return F("COMMAND");
+    }
+    return F("?");
+}
+
+void BlackBox_status(Print &p) {
+    uint32_t h = head.load(std::memory_order_acquire);
+    p.print(F("[BB] "));
+    p.print(frozen.load(std::memory_order_relaxed) ? F("FROZEN") : F("RECORDING"));
+    p.print(F(", reason="));
+    p.print(reasonName(reason.load(std::memory_order_relaxed)));
+    p.print(F(", samples="));
+    p.print(readableCount(h));
+    p.print('/');
+    p.println(BLACKBOX_SAMPLES);
+}
+
+void BlackBox_dump(Print &p) {
+    BlackBox_freeze();
+    uint32_t h = head.load(std::memory_order_acquire);
+    uint32_t count = readableCount(h);
+
+    uint8_t header[BLACKBOX_HEADER_LEN] = {
+        'B', 'B', 'B', 'X', BLACKBOX_VERSION, uint8_t(sizeof(BlackBoxSample)),
+        reason.load(std::memory_order_relaxed), 0,
+        uint8_t(count), uint8_t(count >> 8), uint8_t(count >> 16), uint8_t(count >> 24)
+    };
+
+    p.print(F("[BB] BEGIN "));
+    p.println(uint32_t(BLACKBOX_HEADER_LEN + count * sizeof(BlackBoxSample)));
+    p.write(header, sizeof(header));
+    for (uint32_t i = h - count; i != h; i++) {
+        p.write(reinterpret_cast<const uint8_t *>(&ring[i % BLACKBOX_SAMPLES]), sizeof(BlackBoxSample));
+    }
+    p.println();
+    p.println(F("[BB] END"));
+}
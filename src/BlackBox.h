@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+
+// In-RAM flight recorder: one packed sample per control tick in a fixed ring
+// (BLACKBOX_SAMPLES ticks of history, no allocation). A failsafe event
+// freezes the ring BLACKBOX_POST_TRIGGER ticks later, so both the lead-up and
+// the reaction are kept; BBF freezes immediately, BB- clears and re-arms.
+//
+// BB> dumps the frozen ring (freezing it first if needed) as one blob:
+//
+//   "[BB] BEGIN <n>\r\n" <n bytes> "\r\n[BB] END\r\n"
+//
+// Blob: "BBBX", u8 version, u8 sample size, u8 freeze reason, u8 reserved,
+// u32 LE sample count, then the samples oldest first (layout below, LE).
+// The native build turns it into CSV with --decode-bb.
+
+constexpr uint16_t BLACKBOX_SAMPLES      = 512;   // 5.12 s at 10 ms
+constexpr uint16_t BLACKBOX_POST_TRIGGER = 50;    // ticks kept after a failsafe event
+constexpr uint8_t  BLACKBOX_VERSION      = 1;
+constexpr uint8_t  BLACKBOX_HEADER_LEN   = 12;
+
+enum class BlackBoxReason : uint8_t {
+    NONE,
+    FAILSAFE,
+    COMMAND
+};
+
+// Failsafe flag bits in BlackBoxSample::flags
+constexpr uint8_t BB_FLAG_LINK_TIMEOUT = 0x01;
+
+struct __attribute__((packed)) BlackBoxSample {
+    uint32_t tUs;            // tick start (Hal_micros)
+    int16_t  driveLeft;      // Drive targets, ±MAX_PWM
+    int16_t  driveRight;
+    uint16_t weaponUs;       // ramp output
+    uint16_t weaponTargetUs;
+    uint16_t notchOutUs;     // after the notch filter, as sent to the ESC
+    uint16_t tickUs;         // control step duration up to this sample
+    uint8_t  weaponState;    // WeaponState
+    uint8_t  flags;          // BB_FLAG_*
+};
+
+static_assert(sizeof(BlackBoxSample) == 18, "BlackBoxSample must stay packed");
+
+void BlackBox_init();
+
+// Control task
+void BlackBox_record(const BlackBoxSample &s);
+void BlackBox_trigger();                    // failsafe event
+
+// Comms side
+void BlackBox_freeze();
+void BlackBox_clear();                      // applied on the next tick
+void BlackBox_status(Print &p);
+void BlackBox_dump(Print &p);
@@ -1,57 +1,57 @@
 #include "BluetoothComm.h"
-#include <BluetoothSerial.h>
 #include "DebugIO.h"
 #include "Diagnostics.h"
+#include "Hal.h"
+#include "Log.h"
 
-static BluetoothSerial SerialBT;
-static String btBuffer;
+// Ein Framer pro Quelle: USB- und BT-Bytes können sich nicht mehr vermischen
+static LineFramer framers[int(HalTransport::COUNT)];
 
 void BluetoothComm_init() {
-    SerialBT.begin("BattleBotESP");
-    btBuffer.reserve(32);
+    Hal_btBegin("BattleBotESP");
+    for (LineFramer &f : framers) {
+        f.reset();
+    }
 }
 
-bool BluetoothComm_poll(String &outLine, unsigned long /*nowMs*/) {
-    // Check Serial (USB) first
-    while (Serial.available()) {
-        char c = Serial.read();
-        if (c == '\n' || c == '\r') {
-            if (btBuffer.length() > 0) {
-                DebugIO_pulseInput();
-                outLine = btBuffer;
-                btBuffer = "";
-                outLine.trim();
-                return true;
-            }
-        } else {
-            btBuffer += c;
-            if (btBuffer.length() > 16) {
-                Diag_incBtBufferOverflow();
-                Serial.println(F("[ERR] Serial buffer overflow, discarding input"));
-                btBuffer = "";
-            }
+// Alle verfügbaren Bytes einlesen. Ist der Ring voll, bleiben die restlichen
+// Bytes im Transport-Puffer und werden im nächsten Durchlauf gelesen.
+static void pumpTransport(HalTransport t) {
+    LineFramer &framer = framers[int(t)];
+    // Ein Stempel pro Durchlauf, vor dem ersten Byte: spart Hal_micros() je
+    // Byte, die Latenz wird dadurch höchstens um die Dauer des Durchlaufs zu groß
+    uint32_t rxUs = Hal_micros();
+
+    while (framer.pending() < LINE_RING_SLOTS && Hal_transportAvailable(t)) {
+        switch (framer.push(char(Hal_transportRead(t)), rxUs)) {
+            case LineFramer::PushResult::OVERFLOW:
+                Diag_inc(DiagId::BT_BUFFER_OVERFLOW);
+                LOG_ERR("[ERR] %s buffer overflow, discarding input",
+                        t == HalTransport::USB ? "Serial" : "BT");
+                break;
+            case LineFramer::PushResult::DROPPED:
+                Diag_inc(DiagId::BT_BUFFER_OVERFLOW);
+                break;
+            case LineFramer::PushResult::BAD_FRAME:
+                Diag_inc(DiagId::BINARY_FRAME_ERROR);
+                break;
+            default:
+                break;
         }
     }
+}
+
+uint8_t BluetoothComm_poll(LineView *outLines, uint32_t *outRxUs, uint8_t maxLines, unsigned long /*nowMs*/) {
+    uint8_t n = 0;
 
-    // Check Bluetooth
-    while (SerialBT.available()) {
-        char c = SerialBT.read();
-        if (c == '\n' || c == '\r') {
-            if (btBuffer.length() > 0) {
-                DebugIO_pulseInput();
-                outLine = btBuffer;
-                btBuffer = "";
-                outLine.trim();
-                return true;
-            }
-        } else {
-            btBuffer += c;
-            if (btBuffer.length() > 16) {
-                Diag_incBtBufferOverflow();
-                Serial.println(F("[ERR] BT buffer overflow, discarding input"));
-                btBuffer = "";
-            }
+    // Serial (USB) first, then Bluetooth
+    for (int t = 0; t < int(HalTransport::COUNT); t++) {
+        LineFramer &framer = framers[t];
+        pumpTransport(HalTransport(t));
+        while (n < maxLines && framer.pop(outLines[n], &outRxUs[n])) {
+            DebugIO_pulseInput();
+            n++;
         }
     }
-    return false;
+    return n;
 }
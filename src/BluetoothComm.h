@@ -1,6 +1,18 @@
 #pragma once
 
 #include <Arduino.h>
+#include "Hal.h"
+#include "LineFramer.h"
+
+// Obergrenze fertiger Zeilen pro Poll (alle Quellen zusammen)
+constexpr uint8_t COMM_MAX_LINES_PER_POLL = LINE_RING_SLOTS * uint8_t(HalTransport::COUNT);
 
 void BluetoothComm_init();
-bool BluetoothComm_poll(String &outLine, unsigned long nowMs);
+
+// Liest alle verfügbaren Bytes aller Quellen und liefert alle fertigen
+// Zeilen (USB vor Bluetooth, je Quelle in Empfangsreihenfolge).
+// Die Views bleiben bis zum nächsten BluetoothComm_poll() gültig.
+// outRxUs: Hal_micros() zu Beginn des Durchlaufs, der die Zeile fertig
+// gelesen hat; ein Stempel für alle Zeilen dieses Durchlaufs, also höchstens
+// früher als das letzte Byte (gemessene Latenz ist eine obere Schranke, Latency.h)
+uint8_t BluetoothComm_poll(LineView *outLines, uint32_t *outRxUs, uint8_t maxLines, unsigned long nowMs);
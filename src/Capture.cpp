@@ -0,0 +1,96 @@
+#include "Capture.h"
+#include "Log.h"
+
+static uint8_t buffer[CAPTURE_BUFFER_SIZE];
+static uint16_t used = 0;
+static uint32_t entries = 0;
+static uint32_t lastUs = 0;
+static bool active = false;
+static bool full = false;
+
+static uint8_t lebLength(uint32_t v) {
+    uint8_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static void putLeb(uint32_t v) {
+    while (v >= 0x80) {
+        buffer[used++] = uint8_t(v | 0x80);
+        v >>= 7;
+    }
+    buffer[used++] = uint8_t(v);
+}
+
+static void putLe32(uint8_t *out, uint32_t v) {
+    for (uint8_t i = 0; i < 4; i++) out[i] = uint8_t(v >> (8 * i));
+}
+
+void Capture_init() {
+    used = 0;
+    entries = 0;
+    lastUs = 0;
+    active = false;
+    full = false;
+}
+
+void Capture_start(uint32_t nowUs) {
+    Capture_init();
+    lastUs = nowUs;
+    active = true;
+}
+
+void Capture_stop() {
+    active = false;
+}
+
+bool Capture_isActive() {
+    return active;
+}
+
+void Capture_line(const LineView &line, uint32_t rxUs) {
+    if (!active) return;
+
+    uint32_t delayUs = rxUs - lastUs;
+    size_t need = lebLength(delayUs) + lebLength(uint32_t(line.length())) + line.length();
+    if (used + need > CAPTURE_BUFFER_SIZE) {
+        active = false;
+        full = true;
+        LOG_WRN("[REC] Buffer full after %u lines, capture stopped", entries);
+        return;
+    }
+
+    putLeb(delayUs);
+    putLeb(uint32_t(line.length()));
+    memcpy(buffer + used, line.data(), line.length());
+    used = uint16_t(used + line.length());
+    lastUs = rxUs;
+    entries++;
+}
+
+void Capture_status(Print &p) {
+    p.print(F("[REC] "));
+    p.print(active ? F("RECORDING") : (full ? F("FULL") : F("STOPPED")));
+    p.print(F(", lines="));
+    p.print(entries);
+    p.print(F(", bytes="));
+    p.print(used);
+    p.print('/');
+    p.println(CAPTURE_BUFFER_SIZE);
+}
+
+void Capture_dump(Print &p) {
+    uint8_t header[CAPTURE_HEADER_LEN] = {'B', 'B', 'R', 'C', CAPTURE_VERSION};
+    putLe32(header + 5, entries);
+    putLe32(header + 9, used);
+
+    p.print(F("[REC] BEGIN "));
+    p.println(uint32_t(CAPTURE_HEADER_LEN) + used);
+    p.write(header, sizeof(header));
+    p.write(buffer, used);
+    p.println();
+    p.println(F("[REC] END"));
+}
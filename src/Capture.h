@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+#include "LineFramer.h"
+
+// Command stream capture for host replay.
+// While active, every framed line handed to the parser is appended to a
+// fixed RAM buffer together with its framing time (see Latency.h). When the
+// buffer is full, capture stops. REC> dumps the buffer as one binary blob:
+//
+//   "[REC] BEGIN <n>\r\n" <n bytes> "\r\n[REC] END\r\n"
+//
+// Blob: "BBRC", u8 version, u32 LE entry count, u32 LE payload bytes, then
+// per entry: LEB128 delay in µs since the previous entry (first: since
+// REC+), LEB128 length, line bytes (text without terminator, or a complete
+// binary frame). The native build replays it with --replay.
+// Comms side only.
+
+constexpr uint16_t CAPTURE_BUFFER_SIZE = 16384;
+constexpr uint8_t  CAPTURE_VERSION     = 1;
+constexpr uint8_t  CAPTURE_HEADER_LEN  = 13;
+
+void Capture_init();
+void Capture_start(uint32_t nowUs);   // clears the buffer
+void Capture_stop();
+bool Capture_isActive();
+
+void Capture_line(const LineView &line, uint32_t rxUs);
+
+void Capture_status(Print &p);
+void Capture_dump(Print &p);
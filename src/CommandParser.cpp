@@ -1,18 +1,108 @@
 #include "CommandParser.h"
-#include "Drive.h"
-#include "Weapon.h"
 #include "Config.h"
 #include "Diagnostics.h"
 #include "Failsafe.h"
 #include "Leds.h"
 #include "NotchFilter.h"
+#include "BinaryProtocol.h"
+#include "MotionMixer.h"
+#include "ControlQueue.h"
+#include "ControlLoop.h"
+#include "Perf.h"
+#include "EscOutput.h"
+#include "WeaponRamp.h"
+#include "Capture.h"
+#include "BlackBox.h"
+#include "BluetoothComm.h"
+#include "Hal.h"
+#include "Log.h"
 #include <Arduino.h>
 
-static void handleMotion(const String &input, unsigned long nowMs);
-static void handleFunction(char cmd, unsigned long nowMs);
+static void handleMotion(const LineView &input, unsigned long nowMs, uint32_t rxUs);
+static bool parseMotion(const LineView &input, int32_t &T, int32_t &S);
+static void postMotion(int32_t T, int32_t S, unsigned long nowMs, uint32_t rxUs);
+static void handleFunction(char cmd, unsigned long nowMs, uint32_t rxUs);
+static void handleMixer(const LineView &line);
+static void handleRamp(const LineView &line);
+static bool parseNotchSpec(const LineView &text, NotchSpec &out);
+static void handleNotchSelect(const LineView &arg);
+static void handleNotchLoad(const LineView &arg);
+static bool isMotionLine(const LineView &line);
+static void handleBinary(const LineView &frame, unsigned long nowMs, uint32_t rxUs);
+static bool acceptBinaryFrame(const LineView &frame);
+static void applyBinaryFrame(const LineView &frame, unsigned long nowMs, uint32_t rxUs);
 
-void CommandParser_handleLine(const String &line, unsigned long nowMs)
+static bool binSeqValid = false;
+static uint8_t binLastSeq = 0;
+
+void CommandParser_handleLine(const LineView &line, unsigned long nowMs, uint32_t rxUs)
 {
+    // Binary frames start with the sync byte (never part of a text command)
+    if (line.length() >= 1 && uint8_t(line[0]) == BIN_SYNC)
+    {
+        handleBinary(line, nowMs, rxUs);
+        return;
+    }
+
+    // Command stream capture: REC+ | REC- | REC? | REC>
+    if (line == "REC+" || line == "REC-" || line == "REC?" || line == "REC>")
+    {
+        switch (line[3]) {
+            case '+':
+                Capture_start(rxUs == LATENCY_NO_STAMP ? Hal_micros() : rxUs);
+                LOG_INF("[REC] Capture started");
+                break;
+            case '-':
+                Capture_stop();
+                LOG_INF("[REC] Capture stopped");
+                break;
+            case '?':
+                Capture_status(Serial);
+                break;
+            default:
+                Capture_dump(Serial);
+                break;
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Black-box recorder: BB? | BBF | BB- | BB>
+    if (line == "BB?" || line == "BBF" || line == "BB-" || line == "BB>")
+    {
+        switch (line[2]) {
+            case '?':
+                BlackBox_status(Serial);
+                break;
+            case 'F':
+                BlackBox_freeze();
+                LOG_INF("[BB] Recorder frozen");
+                break;
+            case '-':
+                BlackBox_clear();
+                LOG_INF("[BB] Recorder cleared");
+                break;
+            default:
+                BlackBox_dump(Serial);
+                break;
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Command-to-actuator latency: LAT? | LAT- (before the LED commands)
+    if (line == "LAT?" || line == "LAT-")
+    {
+        if (line[3] == '?') {
+            Latency_dump(Serial);
+        } else {
+            Latency_reset();
+            LOG_INF("[LAT] Histograms reset");
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
     // LED commands start with 'L'
     if (line.length() >= 2 && line[0] == 'L')
     {
@@ -21,6 +111,85 @@ void CommandParser_handleLine(const String &line, unsigned long nowMs)
         return;
     }
 
+    // Mixer/response curve commands start with "MX"
+    if (line.startsWith("MX"))
+    {
+        handleMixer(line);
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Weapon ramp profile commands start with "WR"
+    if (line.startsWith("WR"))
+    {
+        handleRamp(line);
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Proportional weapon setpoint: WT=<ESC_ARM_US..ESC_MAX_US>
+    if (line.startsWith("WT="))
+    {
+        long us = line.length() > 3 ? line.substring(3).toInt() : -1;
+        if (us >= ESC_ARM_US && us <= ESC_MAX_US) {
+            ControlQueue_post(ControlCmdType::WEAPON_THROTTLE, int(us), 0, rxUs);
+        } else {
+            LOG_ERR("[WPN] ERROR: Format WT=<%d..%d>", ESC_ARM_US, ESC_MAX_US);
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Control tick statistics: CT? | CT-
+    if (line == "CT?" || line == "CT-")
+    {
+        if (line[2] == '?') {
+            ControlLoop_dump(Serial);
+        } else {
+            ControlLoop_resetStats();
+            LOG_INF("[CT] Stats reset");
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Execution time histograms: PERF? | PERF-
+    if (line == "PERF?" || line == "PERF-")
+    {
+        if (line[4] == '?') {
+            Perf_dump(Serial);
+        } else {
+            Perf_reset();
+            LOG_INF("[PERF] Histograms reset");
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Error counters: DIAG? (one line, changes since the last DIAG?)
+    if (line == "DIAG?")
+    {
+        Diag_dump(Serial);
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
+    // Weapon ESC protocol: ESC? | ESC=<PWM50|PWM400|OS125|MULTI|DSHOT300|DSHOT600>
+    if (line.startsWith("ESC"))
+    {
+        EscProtocol protocol;
+        if (line == "ESC?") {
+            LOG_INF("[WPN] ESC protocol %s", EscOutput_protocolName(EscOutput_getProtocol()));
+        } else if (line.length() > 4 && line[3] == '=' &&
+                   EscOutput_parseProtocol(line.data() + 4, line.length() - 4, protocol)) {
+            ControlQueue_post(ControlCmdType::ESC_PROTOCOL, int(protocol));
+        } else {
+            LOG_ERR("[WPN] ERROR: Format ESC=<PWM50|PWM400|OS125|MULTI|DSHOT300|DSHOT600>");
+        }
+        Failsafe_onAnyCommand(nowMs);
+        return;
+    }
+
     // Notch Filter commands start with "NF"
     if (line.length() >= 2 && line.startsWith("NF"))
     {
@@ -29,110 +198,189 @@ void CommandParser_handleLine(const String &line, unsigned long nowMs)
         }
         else if (line == "NF-") {
             NotchFilter_clear();
-            Serial.println(F("[NF] All notches cleared"));
+            LOG_INF("[NF] All notches cleared");
         }
         else if (line.startsWith("NFEN=")) {
             int val = line.substring(5).toInt();
             NotchFilter_setEnabled(val != 0);
-            Serial.print(F("[NF] Filter "));
-            Serial.println(val != 0 ? F("ENABLED") : F("DISABLED"));
+            LOG_INF("[NF] Filter %s", val != 0 ? "ENABLED" : "DISABLED");
         }
         else if (line.startsWith("NF+")) {
             // Format: NF+centerUs,halfWidthUs,depth
-            String params = line.substring(3);
-            int comma1 = params.indexOf(',');
-            int comma2 = params.indexOf(',', comma1 + 1);
-            
-            if (comma1 > 0 && comma2 > comma1) {
-                int centerUs = params.substring(0, comma1).toInt();
-                int halfWidthUs = params.substring(comma1 + 1, comma2).toInt();
-                float depth = params.substring(comma2 + 1).toFloat();
-                
+            NotchSpec spec;
+            if (parseNotchSpec(line.substring(3), spec)) {
                 uint32_t id;
-                if (NotchFilter_add(centerUs, halfWidthUs, depth, &id)) {
-                    Serial.print(F("[NF] Added notch ID="));
-                    Serial.print(id);
-                    Serial.print(F(" center="));
-                    Serial.print(centerUs);
-                    Serial.print(F("us, width=±"));
-                    Serial.print(halfWidthUs);
-                    Serial.print(F("us, depth="));
-                    Serial.println(depth, 2);
+                if (NotchFilter_add(spec.centerUs, spec.halfWidthUs, spec.depth, &id)) {
+                    LOG_INF("[NF] Added notch ID=%u center=%dus, width=±%dus, depth=%d%%",
+                            id, spec.centerUs, spec.halfWidthUs, int(spec.depth * 100.0f + 0.5f));
                 } else {
-                    Serial.println(F("[NF] ERROR: Failed to add notch (check params/max)"));
+                    LOG_ERR("[NF] ERROR: Failed to add notch (check params/max)");
                 }
             } else {
-                Serial.println(F("[NF] ERROR: Format NF+centerUs,halfWidthUs,depth"));
+                LOG_ERR("[NF] ERROR: Format NF+centerUs,halfWidthUs,depth");
             }
         }
+        else if (line == "NFM=A" || line == "NFM=S") {
+            bool skip = (line[4] == 'S');
+            NotchFilter_setMode(skip ? NotchMode::SKIP : NotchMode::ATTENUATE);
+            LOG_INF("[NF] Mode %s", skip ? "SKIP" : "ATTENUATE");
+        }
+        else if (line == "NFB?") {
+            NotchFilter_dumpBanks(Serial);
+        }
+        else if (line.startsWith("NFS")) {
+            handleNotchSelect(line.substring(3));
+        }
+        else if (line.startsWith("NFL")) {
+            handleNotchLoad(line.substring(3));
+        }
         else if (line.startsWith("NF#")) {
             uint32_t id = line.substring(3).toInt();
             if (NotchFilter_removeById(id)) {
-                Serial.print(F("[NF] Removed notch ID="));
-                Serial.println(id);
+                LOG_INF("[NF] Removed notch ID=%u", id);
             } else {
-                Serial.print(F("[NF] ERROR: Notch ID="));
-                Serial.print(id);
-                Serial.println(F(" not found"));
+                LOG_ERR("[NF] ERROR: Notch ID=%u not found", id);
             }
         }
         else {
-            Serial.println(F("[NF] Unknown command. Use: NF?, NF-, NF+, NF#, NFEN="));
+            LOG_WRN("[NF] Unknown command. Use: NF?, NF-, NF+, NF#, NFEN=, NFM=, NFB?, NFS, NFL");
         }
         
         Failsafe_onAnyCommand(nowMs);
         return;
     }
 
-    if (line.length() == 6)
+    if (isMotionLine(line))
     {
-        handleMotion(line, nowMs);
+        handleMotion(line, nowMs, rxUs);
         Failsafe_onAnyCommand(nowMs);
     }
     else if (line.length() == 1)
     {
-        handleFunction(line[0], nowMs);
+        handleFunction(line[0], nowMs, rxUs);
         Failsafe_onAnyCommand(nowMs);
     }
     else
     {
-        Serial.print(F("[DBG] Unknown cmd (len!=1/6): \""));
-        Serial.print(line);
-        Serial.println(F("\""));
-        Diag_incInvalidMotionFormat(); // generischer Formatfehler
+        LOG_DBG("[DBG] Unknown cmd (len=%u, first='%c')", unsigned(line.length()), line[0]);
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT); // generischer Formatfehler
     }
 }
 
-static void handleMotion(const String &input, unsigned long nowMs)
+// Gleiche Reihenfolge wie die Verteilung in CommandParser_handleLine
+static bool isMotionLine(const LineView &line)
+{
+    if (line.length() >= 1 && uint8_t(line[0]) == BIN_SYNC) return true; // alle Binärtypen sind Fahrkommandos
+    if (line.length() != 6) return false;
+    if (line[0] == 'L') return false;
+    if (line.startsWith("NF") || line.startsWith("MX") || line.startsWith("WR") ||
+        line.startsWith("WT") || line.startsWith("ESC")) return false;
+    return true;
+}
+
+void CommandParser_handleBatch(const LineView *lines, const uint32_t *rxUs, uint8_t count,
+                               unsigned long nowMs)
+{
+    if (count > COMM_MAX_LINES_PER_POLL) count = COMM_MAX_LINES_PER_POLL;
+
+    // Fahrkommandos zuerst prüfen (Binär: CRC + Sequenz, Text: Format).
+    // Nur ein angenommenes Kommando überholt ältere; ein verworfenes
+    // (Duplikat, CRC-Fehler, Formatfehler) verdrängt nie eine gültige Position.
+    bool accepted[COMM_MAX_LINES_PER_POLL];
+    int32_t motionT[COMM_MAX_LINES_PER_POLL];
+    int32_t motionS[COMM_MAX_LINES_PER_POLL];
+    int lastMotion = -1;
+    for (int i = 0; i < count; i++)
+    {
+        // Mitschnitt vor dem Verwerfen: Replay durchläuft dieselbe Koaleszenz
+        if (!lines[i].startsWith("REC")) Capture_line(lines[i], rxUs[i]);
+
+        accepted[i] = false;
+        if (!isMotionLine(lines[i])) continue;
+        if (uint8_t(lines[i][0]) == BIN_SYNC)
+            accepted[i] = acceptBinaryFrame(lines[i]);
+        else
+            accepted[i] = parseMotion(lines[i], motionT[i], motionS[i]);
+        if (accepted[i]) lastMotion = i;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!isMotionLine(lines[i]))
+        {
+            PERF_SCOPE(PerfId::PARSER_LINE);
+            CommandParser_handleLine(lines[i], nowMs, rxUs[i]);
+            continue;
+        }
+
+        bool binary = (uint8_t(lines[i][0]) == BIN_SYNC);
+        if (i == lastMotion)
+        {
+            PERF_SCOPE(PerfId::PARSER_LINE);
+            if (binary)
+            {
+                applyBinaryFrame(lines[i], nowMs, rxUs[i]);
+            }
+            else
+            {
+                postMotion(motionT[i], motionS[i], nowMs, rxUs[i]);
+                Failsafe_onAnyCommand(nowMs);
+            }
+        }
+        else if (accepted[i])
+        {
+            Diag_inc(DiagId::COALESCED_COMMAND); // überholt durch neueres Fahrkommando
+        }
+        else if (!binary && lastMotion < 0)
+        {
+            // kein gültiges Fahrkommando im Durchlauf: defensiv stoppen wie handleMotion
+            ControlQueue_post(ControlCmdType::DRIVE, 0, 0, rxUs[i]);
+            Failsafe_onAnyCommand(nowMs);
+        }
+        // verworfene Binärframes sind in acceptBinaryFrame bereits gezählt
+    }
+}
+
+static void handleMotion(const LineView &input, unsigned long nowMs, uint32_t rxUs)
+{
+    int32_t T, S;
+    if (!parseMotion(input, T, S))
+    {
+        ControlQueue_post(ControlCmdType::DRIVE, 0, 0, rxUs); // defensiv: Stop
+        return;
+    }
+    postMotion(T, S, nowMs, rxUs);
+}
+
+// Prüft ein Text-Fahrkommando und zählt Fehler; false = verwerfen.
+// T/S: vorzeichenbehaftet, noch ungemischt (gemischt wird erst beim Anwenden)
+static bool parseMotion(const LineView &input, int32_t &T, int32_t &S)
 {
     // Format: [0]=F/B, [1..2]=00..99, [3]=L/R, [4..5]=00..99
     if (input.length() != 6)
     {
-        Diag_incInvalidMotionFormat();
-        Serial.println(F("[ERR] Motion length != 6"));
-        Drive_setTargets(0, 0);
-        return;
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT);
+        LOG_ERR("[ERR] Motion length != 6");
+        return false;
     }
 
     char moveDir = input[0];
-    String spStr = input.substring(1, 3);
+    LineView spStr = input.substring(1, 3);
     char steerDir = input[3];
-    String angStr = input.substring(4, 6);
+    LineView angStr = input.substring(4, 6);
 
     if (spStr.length() != 2 || !isDigit(spStr.charAt(0)) || !isDigit(spStr.charAt(1)))
     {
-        Diag_incInvalidMotionFormat();
-        Serial.println(F("[ERR] Motion speed not numeric"));
-        Drive_setTargets(0, 0);
-        return;
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT);
+        LOG_ERR("[ERR] Motion speed not numeric");
+        return false;
     }
 
     if (angStr.length() != 2 || !isDigit(angStr.charAt(0)) || !isDigit(angStr.charAt(1)))
     {
-        Diag_incInvalidMotionFormat();
-        Serial.println(F("[ERR] Motion angle not numeric"));
-        Drive_setTargets(0, 0);
-        return;
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT);
+        LOG_ERR("[ERR] Motion angle not numeric");
+        return false;
     }
 
     int moveSpeed = spStr.toInt();   // 0..99
@@ -141,126 +389,352 @@ static void handleMotion(const String &input, unsigned long nowMs)
     // Begrenzen
     if (moveSpeed < 0 || moveSpeed > 99)
     {
-        Diag_incInvalidMotionFormat();
-        Serial.println(F("[ERR] Motion speed out of range"));
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT);
+        LOG_ERR("[ERR] Motion speed out of range");
         moveSpeed = constrain(moveSpeed, 0, 99);
     }
     if (steerAngle < 0 || steerAngle > 99)
     {
-        Diag_incInvalidMotionFormat();
-        Serial.println(F("[ERR] Motion angle out of range"));
+        Diag_inc(DiagId::INVALID_MOTION_FORMAT);
+        LOG_ERR("[ERR] Motion angle out of range");
         steerAngle = constrain(steerAngle, 0, 99);
     }
 
-    float Tsign;
+    int32_t Tsign;
     if (moveDir == 'F')
-        Tsign = 1.0f;
+        Tsign = 1;
     else if (moveDir == 'B')
-        Tsign = -1.0f;
+        Tsign = -1;
     else
     {
-        Diag_incInvalidMoveDir();
-        Serial.print(F("[ERR] Invalid moveDir: "));
-        Serial.println(moveDir);
+        Diag_inc(DiagId::INVALID_MOVE_DIR);
+        LOG_ERR("[ERR] Invalid moveDir: %c", moveDir);
         // defensive: kein Move -> Stop
-        Drive_setTargets(0, 0);
-        return;
+        return false;
     }
 
-    float Ssign;
+    int32_t Ssign;
     if (steerDir == 'R')
-        Ssign = 1.0f;
+        Ssign = 1;
     else if (steerDir == 'L')
-        Ssign = -1.0f;
+        Ssign = -1;
     else
     {
-        Diag_incInvalidSteerDir();
-        Serial.print(F("[ERR] Invalid steerDir: "));
-        Serial.println(steerDir);
+        Diag_inc(DiagId::INVALID_STEER_DIR);
+        LOG_ERR("[ERR] Invalid steerDir: %c", steerDir);
         // defensive: kein Lenken, aber geradeaus fahren ok:
-        Ssign = 0.0f;
+        Ssign = 0;
+    }
+
+    T = Tsign * MotionMixer_fromPercent99(uint8_t(moveSpeed));
+    S = Ssign * MotionMixer_fromPercent99(uint8_t(steerAngle));
+    return true;
+}
+
+static void postMotion(int32_t T, int32_t S, unsigned long nowMs, uint32_t rxUs)
+{
+    int leftTarget, rightTarget;
+    MotionMixer_mix(T, S, leftTarget, rightTarget);
+
+    ControlQueue_post(ControlCmdType::DRIVE, leftTarget, rightTarget, rxUs);
+    Failsafe_onMotionCommand(nowMs);
+
+    LOG_DBG("[DBG] Motion: T=%d S=%d -> L=%d R=%d", int(T), int(S), leftTarget, rightTarget);
+}
+
+static void handleMixer(const LineView &line)
+{
+    // MX? | MXL | MXE<0..100> | MXT | MXP<idx>=<permille>
+    if (line == "MX?")
+    {
+        MotionMixer_dump(Serial);
+    }
+    else if (line == "MXL")
+    {
+        MotionMixer_setCurve(MixCurve::LINEAR);
+        LOG_INF("[MX] Curve LINEAR");
+    }
+    else if (line == "MXT")
+    {
+        MotionMixer_setCurve(MixCurve::TABLE);
+        LOG_INF("[MX] Curve TABLE");
+    }
+    else if (line.startsWith("MXE") && line.length() > 3)
+    {
+        long pct = line.substring(3).toInt();
+        if (pct >= 0 && pct <= 100 && MotionMixer_setExpo(uint8_t(pct)))
+        {
+            MotionMixer_setCurve(MixCurve::EXPO);
+            LOG_INF("[MX] Curve EXPO %d%%", pct);
+        }
+        else
+        {
+            LOG_ERR("[MX] ERROR: expo 0..100");
+        }
+    }
+    else if (line.startsWith("MXP"))
+    {
+        int eq = line.indexOf('=');
+        long idx = (eq > 3) ? line.substring(3, eq).toInt() : -1;
+        long val = (eq > 3) ? line.substring(eq + 1).toInt() : -1;
+        if (idx >= 0 && idx < MIX_TABLE_POINTS && val >= 0 && val <= 1000 &&
+            MotionMixer_setTablePoint(uint8_t(idx), uint16_t(val)))
+        {
+            LOG_INF("[MX] Point %d = %d", idx, val);
+        }
+        else
+        {
+            LOG_ERR("[MX] ERROR: Format MXP<0..16>=<0..1000>");
+        }
+    }
+    else
+    {
+        LOG_WRN("[MX] Unknown command. Use: MX?, MXL, MXE<pct>, MXT, MXP<i>=<v>");
+    }
+}
+
+static void handleRamp(const LineView &line)
+{
+    // WR? | WRU=<L|S|T> | WRD=<L|S|T> | WRP<idx>=<permille>
+    // Ramp state belongs to the control task: changes go through the queue
+    if (line == "WR?")
+    {
+        WeaponRamp_dump(Serial);
+    }
+    else if (line.length() == 5 && (line[2] == 'U' || line[2] == 'D') && line[3] == '=' &&
+             (line[4] == 'L' || line[4] == 'S' || line[4] == 'T'))
+    {
+        bool up = (line[2] == 'U');
+        RampProfile profile = line[4] == 'S' ? RampProfile::SCURVE :
+                              line[4] == 'T' ? RampProfile::TABLE : RampProfile::LINEAR;
+        ControlQueue_post(ControlCmdType::RAMP_PROFILE, up ? 1 : 0, int(profile));
+        LOG_INF("[WR] %s profile %s", up ? "Up" : "Down",
+                line[4] == 'S' ? "SCURVE" : line[4] == 'T' ? "TABLE" : "LINEAR");
+    }
+    else if (line.startsWith("WRP"))
+    {
+        int eq = line.indexOf('=');
+        long idx = (eq > 3) ? line.substring(3, eq).toInt() : -1;
+        long val = (eq > 3) ? line.substring(eq + 1).toInt() : -1;
+        if (idx >= 0 && idx < RAMP_TABLE_POINTS && val >= 0 && val <= 1000)
+        {
+            ControlQueue_post(ControlCmdType::RAMP_POINT, int(idx), int(val));
+            LOG_INF("[WR] Point %d = %d", idx, val);
+        }
+        else
+        {
+            LOG_ERR("[WR] ERROR: Format WRP<0..16>=<0..1000>");
+        }
+    }
+    else
+    {
+        LOG_WRN("[WR] Unknown command. Use: WR?, WRU=<L|S|T>, WRD=<L|S|T>, WRP<i>=<v>");
     }
+}
 
-    float T = Tsign * (moveSpeed / 99.0f);
-    float S = Ssign * (steerAngle / 99.0f);
+// "centerUs,halfWidthUs,depth"
+static bool parseNotchSpec(const LineView &text, NotchSpec &out)
+{
+    int comma1 = text.indexOf(',');
+    int comma2 = text.indexOf(',', comma1 + 1);
+    if (comma1 <= 0 || comma2 <= comma1) return false;
 
-    float left = T + S;
-    float right = T - S;
+    out.centerUs = text.substring(0, comma1).toInt();
+    out.halfWidthUs = text.substring(comma1 + 1, comma2).toInt();
+    out.depth = text.substring(comma2 + 1).toFloat();
+    return true;
+}
 
-    if (left > 1.0f)
-        left = 1.0f;
-    if (left < -1.0f)
-        left = -1.0f;
-    if (right > 1.0f)
-        right = 1.0f;
-    if (right < -1.0f)
-        right = -1.0f;
+static void handleNotchSelect(const LineView &arg)
+{
+    // NFS<bank> | NFS=<name>
+    int bank = -1;
+    if (arg.length() == 1 && isDigit(arg[0]))
+    {
+        bank = arg[0] - '0';
+    }
+    else if (arg.length() > 1 && arg[0] == '=')
+    {
+        bank = NotchFilter_findBank(arg.data() + 1, arg.length() - 1);
+    }
 
-    int leftTarget = int(left * MAX_PWM);
-    int rightTarget = int(right * MAX_PWM);
+    if (bank >= 0 && NotchFilter_selectBank(uint8_t(bank)))
+    {
+        LOG_INF("[NF] Bank %d active", bank);
+    }
+    else
+    {
+        LOG_ERR("[NF] ERROR: Format NFS<0..%u> or NFS=<name>", unsigned(NOTCH_BANK_COUNT - 1));
+    }
+}
+
+static void handleNotchLoad(const LineView &arg)
+{
+    // NFL<bank>=<name>:<c>,<w>,<d>;<c>,<w>,<d>;...   (leere Liste erlaubt)
+    int colon = arg.indexOf(':');
+    if (arg.length() < 3 || !isDigit(arg[0]) || arg[1] != '=' || colon < 3)
+    {
+        LOG_ERR("[NF] ERROR: Format NFL<bank>=<name>:<c>,<w>,<d>;...");
+        return;
+    }
+
+    NotchSpec specs[MAX_NOTCHES];
+    uint8_t count = 0;
+    size_t pos = size_t(colon) + 1;
+    while (pos < arg.length())
+    {
+        int semi = arg.indexOf(';', pos);
+        size_t end = (semi < 0) ? arg.length() : size_t(semi);
+        if (count >= MAX_NOTCHES || !parseNotchSpec(arg.substring(pos, end), specs[count]))
+        {
+            LOG_ERR("[NF] ERROR: Bad notch #%u in bank upload", unsigned(count + 1));
+            return;
+        }
+        count++;
+        pos = end + 1;
+    }
+
+    uint8_t bank = uint8_t(arg[0] - '0');
+    if (NotchFilter_loadBank(bank, arg.data() + 2, size_t(colon) - 2, specs, count))
+    {
+        LOG_INF("[NF] Bank %u loaded, %u notches", bank, count);
+    }
+    else
+    {
+        LOG_ERR("[NF] ERROR: Bank upload rejected (bank/name/params)");
+    }
+}
+
+static int16_t readInt16(const uint8_t *p)
+{
+    return int16_t(uint16_t(p[0]) | (uint16_t(p[1]) << 8));
+}
+
+// Prüft Länge/CRC und Sequenznummer. false = Frame verwerfen.
+static bool acceptBinaryFrame(const LineView &frame)
+{
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(frame.data());
+    uint8_t len = (frame.length() >= 2) ? BinProto_frameLength(raw[1]) : 0;
+
+    if (len == 0 || frame.length() != len || BinProto_crc8(raw + 1, len - 2) != raw[len - 1])
+    {
+        Diag_inc(DiagId::BINARY_FRAME_ERROR);
+        LOG_ERR("[ERR] Binary frame rejected (type/length/CRC)");
+        return false;
+    }
+
+    // Sequenz: Duplikate verwerfen, Lücken zählen
+    uint8_t seq = raw[2];
+    if (binSeqValid)
+    {
+        uint8_t delta = uint8_t(seq - binLastSeq);
+        if (delta == 0)
+        {
+            return false;
+        }
+        if (delta > 1 && delta < 128)
+        {
+            Diag_inc(DiagId::BINARY_SEQ_GAP, delta - 1);
+        }
+    }
+    binSeqValid = true;
+    binLastSeq = seq;
+    return true;
+}
+
+static void handleBinary(const LineView &frame, unsigned long nowMs, uint32_t rxUs)
+{
+    if (!acceptBinaryFrame(frame)) return;
+    applyBinaryFrame(frame, nowMs, rxUs);
+}
+
+// Angenommenen Frame (acceptBinaryFrame) mischen und an den Steuer-Task geben
+static void applyBinaryFrame(const LineView &frame, unsigned long nowMs, uint32_t rxUs)
+{
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(frame.data());
+
+    // Auf ±MIX_FULL_SCALE normieren (int8 * 258 = ±32766)
+    BinMsgType type = BinMsgType(raw[1]);
+    int32_t a, b;
+    if (BinProto_payloadLength(raw[1]) == 2)
+    {
+        a = int32_t(int8_t(raw[3])) * 258;
+        b = int32_t(int8_t(raw[4])) * 258;
+    }
+    else
+    {
+        a = readInt16(raw + 3);
+        b = readInt16(raw + 5);
+    }
+
+    int leftTarget, rightTarget;
+    if (type == BinMsgType::MOTION_TS8 || type == BinMsgType::MOTION_TS16)
+    {
+        // gleiche Mischung wie ASCII: links = T + S, rechts = T - S
+        MotionMixer_mix(a, b, leftTarget, rightTarget);
+    }
+    else
+    {
+        MotionMixer_tracks(a, b, leftTarget, rightTarget);
+    }
 
-    Drive_setTargets(leftTarget, rightTarget);
+    ControlQueue_post(ControlCmdType::DRIVE, leftTarget, rightTarget, rxUs);
     Failsafe_onMotionCommand(nowMs);
+    Failsafe_onAnyCommand(nowMs);
 
-    Serial.print(F("[DBG] Motion: "));
-    Serial.print(input);
-    Serial.print(F(" -> L="));
-    Serial.print(leftTarget);
-    Serial.print(F(" R="));
-    Serial.println(rightTarget);
+    LOG_DBG("[DBG] Motion(bin) seq=%u -> L=%d R=%d", raw[2], leftTarget, rightTarget);
 }
 
-static void handleFunction(char cmd, unsigned long nowMs)
+static void handleFunction(char cmd, unsigned long nowMs, uint32_t rxUs)
 {
     (void)nowMs; // aktuell nicht genutzt, aber für spätere Erweiterungen
 
     switch (cmd)
     {
     case 'U': // Waffe ARM
-        Weapon_armRequest();
+        ControlQueue_post(ControlCmdType::WEAPON_ARM, 0, 0, rxUs);
         break;
 
     case 'u': // Waffe DISARM
-        Weapon_disarm();
+        ControlQueue_post(ControlCmdType::WEAPON_DISARM, 0, 0, rxUs);
         break;
 
     case 'W': // Vollgas (nur ARMED)
-        Weapon_fullThrottle();
+        ControlQueue_post(ControlCmdType::WEAPON_FULL, 0, 0, rxUs);
         break;
 
     case 'w': // Idle (ARM)
-        Weapon_idle();
+        ControlQueue_post(ControlCmdType::WEAPON_IDLE, 0, 0, rxUs);
         break;
 
     // LED-Befehle (von App)
     case 'V': // LEDs AN (weiß)
         Leds_handleCommand("L1FFFFFF");
-        Serial.println(F("[DBG] LEDs ON (white)"));
+        LOG_DBG("[DBG] LEDs ON (white)");
         break;
 
     case 'v': // LEDs AUS
         Leds_handleCommand("L0");
-        Serial.println(F("[DBG] LEDs OFF"));
+        LOG_DBG("[DBG] LEDs OFF");
         break;
 
     case 'X':                             // LED Blink-Effekt (rot)
         Leds_handleCommand("L2FF000010"); // Rot blinken, 1 Sekunde
-        Serial.println(F("[DBG] LEDs BLINK (red)"));
+        LOG_DBG("[DBG] LEDs BLINK (red)");
         break;
 
     case 'Z': // LED Auto-Modus
         Leds_handleCommand("LA");
-        Serial.println(F("[DBG] LEDs AUTO mode"));
+        LOG_DBG("[DBG] LEDs AUTO mode");
         break;
 
     case 'Y': // Horn/Hupe (aktuell keine Hardware)
-        Serial.println(F("[DBG] Horn triggered (no hardware)"));
+        LOG_DBG("[DBG] Horn triggered (no hardware)");
         break;
 
     default:
-        Diag_incInvalidFunctionFormat();
-        Serial.print(F("[DBG] Function cmd ignored: "));
-        Serial.println(cmd);
+        Diag_inc(DiagId::INVALID_FUNCTION_FORMAT);
+        LOG_DBG("[DBG] Function cmd ignored: %c", cmd);
         break;
     }
 }
@@ -1,5 +1,16 @@
 #pragma once
 
 #include <Arduino.h>
+#include "LineFramer.h"
+#include "Latency.h"
 
-void CommandParser_handleLine(const String &line, unsigned long nowMs);
+// rxUs: Framing-Zeitstempel, wird bis Drive/Weapon mitgegeben
+void CommandParser_handleLine(const LineView &line, unsigned long nowMs,
+                              uint32_t rxUs = LATENCY_NO_STAMP);
+
+// Verarbeitet alle Zeilen eines Poll-Durchlaufs in Reihenfolge.
+// Veraltete Fahrkommandos werden verworfen, nur das letzte gültige
+// (CRC/Sequenz bzw. Format geprüft) erreicht Drive_setTargets; alle übrigen
+// Kommandos bleiben erhalten.
+void CommandParser_handleBatch(const LineView *lines, const uint32_t *rxUs, uint8_t count,
+                               unsigned long nowMs);
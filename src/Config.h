@@ -22,30 +22,44 @@ constexpr int PIN_LED_DATA      = 23;   // WS2812B data pin (safe GPIO, avoid bo
 constexpr int LED_COUNT         = 10;   // Number of LEDs in strip/ring
 constexpr uint8_t LED_BRIGHTNESS = 64;  // Default brightness 0..255
 constexpr uint16_t LED_TICK_MS  = 20;   // LED effect update interval (50 Hz)
-constexpr uint16_t LED_SHOW_BUDGET_US = 5000; // Max allowed show() time in microseconds
 
 static_assert(LED_COUNT > 0, "LED_COUNT must be > 0");
 
 // --- LED Zone Layout (for AUTO mode) ---
-// Symmetric layout: [Drive Left] [Weapon Center] [Drive Right]
-constexpr int LED_DRIVE_LEFT_START  = 0;    // Left drive zone start
-constexpr int LED_DRIVE_LEFT_COUNT  = 3;    // Left drive zone: 7 pixels (0-6)
-constexpr int LED_WEAPON_START      = 3;    // Weapon zone start (center)
-constexpr int LED_WEAPON_COUNT      = 2;    // Weapon zone: 2 pixels (7-8)
-constexpr int LED_DRIVE_RIGHT_START = 5;    // Right drive zone start
-constexpr int LED_DRIVE_RIGHT_COUNT = 9;    // Right drive zone: 7 pixels (9-15)
+// Symmetric layout: [Drive Left] [Weapon Center] [Drive Right], checked at
+// build time in LedZones.h; LM= loads a different map at runtime
+constexpr int LED_DRIVE_LEFT_START  = 0;    // Left drive zone: 4 pixels (0-3)
+constexpr int LED_DRIVE_LEFT_COUNT  = 4;
+constexpr int LED_WEAPON_START      = 4;    // Weapon zone: 2 pixels (4-5)
+constexpr int LED_WEAPON_COUNT      = 2;
+constexpr int LED_DRIVE_RIGHT_START = 6;    // Right drive zone: 4 pixels (6-9)
+constexpr int LED_DRIVE_RIGHT_COUNT = 4;
 
 // --- Motor PWM Config ---
 constexpr int MOTOR_PWM_FREQ = 20000; // 20 kHz
 constexpr int MOTOR_PWM_RES  = 8;     // 8 Bit
 
-constexpr int MAX_PWM        = 255;   // Max PWM für Motoren
+constexpr int MAX_PWM        = (1 << MOTOR_PWM_RES) - 1;   // Max PWM für Motoren
+static_assert(uint32_t(MOTOR_PWM_FREQ) << MOTOR_PWM_RES <= 80000000UL,
+              "MOTOR_PWM_RES too high for MOTOR_PWM_FREQ (80 MHz LEDC clock)");
 
 // --- Weapon ESC PWM Config ---
 constexpr int WEAPON_PWM_FREQ = 50;   // 50 Hz
 constexpr int WEAPON_PWM_RES  = 16;   // 16 Bit
 constexpr int WEAPON_CHANNEL  = 6;    // LEDC Channel für ESC (Timer 3)
 
+// ESC-Protokoll der Waffe (zur Laufzeit umschaltbar mit ESC=..., nur DISARMED)
+enum class EscProtocol : uint8_t {
+    PWM50,        // 1000..2000 us @ 50 Hz (Standard-Servo-PWM)
+    PWM400,       // 1000..2000 us @ 400 Hz
+    ONESHOT125,   // 125..250 us @ 2 kHz
+    MULTISHOT,    // 5..25 us @ 16 kHz
+    DSHOT300,     // digital, RMT
+    DSHOT600,     // digital, RMT
+    COUNT
+};
+constexpr EscProtocol WEAPON_ESC_PROTOCOL = EscProtocol::PWM50;
+
 // --- ESC Pulszeiten in Mikrosekunden ---
 constexpr int ESC_OFF_US =  988;  // Disarmed
 constexpr int ESC_ARM_US = 1001;  // Armed/Idle
@@ -55,11 +69,27 @@ constexpr int ESC_MAX_US = 2000;  // Vollgas
 constexpr unsigned long WEAPON_RAMP_UP_TIME_MS   = 1000UL;
 constexpr unsigned long WEAPON_RAMP_DOWN_TIME_MS = 800UL;
 
+// --- Skip-Band-Modus (NotchFilter SKIP) ---
+constexpr int WEAPON_SKIP_RATE_US_PER_MS = 20;  // max. sichere Rampe beim Durchqueren eines Bands
+constexpr int NOTCH_SKIP_HYST_US         = 15;  // Hysterese um die Bandmitte beim Seitenwechsel
+
 // --- Arming Zeitdauer ---
 constexpr unsigned long WEAPON_ARM_PULSE_TIME_MS = 1000UL;
 
 // --- Loop Timing ---
 constexpr unsigned long LOOP_INTERVAL_MS = 10UL;  // 100 Hz Steuerloop
+constexpr uint32_t CONTROL_PERIOD_US = LOOP_INTERVAL_MS * 1000UL;  // esp_timer-Periode
+
+// Steuer-Task (Drive/Weapon/Failsafe) auf Core 0, loop() (BT/Parser/LEDs/Log) auf Core 1.
+// Priorität unter den Systemtasks auf Core 0 (IDF: IPC 24, BT-Controller 23,
+// esp_timer 22 - der esp_timer-Task weckt den Steuer-Task und darf nie warten),
+// aber über dem Bluedroid-Host (BTU 20, BTC 19), damit BT-Verkehr den Tick
+// nicht verschiebt. Der Tick ist kurz gegen die 10 ms, der BT-Stack verhungert nicht.
+constexpr uint8_t CONTROL_TASK_CORE     = 0;
+constexpr uint8_t CONTROL_TASK_PRIORITY = 21;
+
+// --- Logging ---
+constexpr uint8_t LOG_DRAIN_PER_PASS = 4;  // max. Log-Zeilen pro loop()-Durchlauf
 
 // --- Failsafe Settings ---
 // Wenn länger als diese Zeit kein Fahrkommando kam -> Motoren stoppen
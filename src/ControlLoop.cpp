@@ -0,0 +1,140 @@
+#include "ControlLoop.h"
+#include "Config.h"
+#include "ControlQueue.h"
+#include "Drive.h"
+#include "Weapon.h"
+#include "Failsafe.h"
+#include "BlackBox.h"
+#include "Hal.h"
+#include "Perf.h"
+#include "Diagnostics.h"
+#include <atomic>
+
+// Written only by the control task, read from the comms side
+static std::atomic<uint32_t> statTicks(0);
+static std::atomic<uint32_t> statPeriodMinUs(UINT32_MAX);
+static std::atomic<uint32_t> statPeriodMaxUs(0);
+static std::atomic<uint32_t> statJitterMaxUs(0);
+static std::atomic<uint32_t> statJitterSumUs(0);
+static std::atomic<uint32_t> statMissed(0);
+static std::atomic<bool>     resetRequested(false);
+
+static uint32_t lastTickUs = 0;
+static bool haveLastTick = false;
+
+static void recordTick(uint32_t nowUs, uint32_t periods) {
+    if (resetRequested.exchange(false, std::memory_order_relaxed)) {
+        statTicks.store(0, std::memory_order_relaxed);
+        statPeriodMinUs.store(UINT32_MAX, std::memory_order_relaxed);
+        statPeriodMaxUs.store(0, std::memory_order_relaxed);
+        statJitterMaxUs.store(0, std::memory_order_relaxed);
+        statJitterSumUs.store(0, std::memory_order_relaxed);
+        statMissed.store(0, std::memory_order_relaxed);
+        haveLastTick = false;
+    }
+
+    if (periods > 1) {
+        statMissed.fetch_add(periods - 1, std::memory_order_relaxed);
+        Diag_inc(DiagId::LOOP_OVERRUN);
+    }
+
+    if (haveLastTick) {
+        uint32_t period = nowUs - lastTickUs;
+        uint32_t expected = periods * CONTROL_PERIOD_US;
+        uint32_t jitter = period > expected ? period - expected : expected - period;
+
+        if (period < statPeriodMinUs.load(std::memory_order_relaxed)) statPeriodMinUs.store(period, std::memory_order_relaxed);
+        if (period > statPeriodMaxUs.load(std::memory_order_relaxed)) statPeriodMaxUs.store(period, std::memory_order_relaxed);
+        if (jitter > statJitterMaxUs.load(std::memory_order_relaxed)) statJitterMaxUs.store(jitter, std::memory_order_relaxed);
+        statJitterSumUs.fetch_add(jitter, std::memory_order_relaxed);
+        statTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastTickUs = nowUs;
+    haveLastTick = true;
+}
+
+static void recordBlackBox(uint32_t startUs) {
+    BlackBoxSample s;
+    int left, right;
+    Drive_getTargets(left, right);
+    s.tUs            = startUs;
+    s.driveLeft      = int16_t(left);
+    s.driveRight     = int16_t(right);
+    s.weaponUs       = uint16_t(Weapon_getCurrentUs());
+    s.weaponTargetUs = uint16_t(Weapon_getTargetThrottleUs());
+    s.notchOutUs     = uint16_t(Weapon_getOutputUs());
+    s.weaponState    = uint8_t(Weapon_getState());
+    s.flags          = Failsafe_isLinkTimeout() ? BB_FLAG_LINK_TIMEOUT : 0;
+    uint32_t tickUs  = Hal_micros() - startUs;
+    s.tickUs         = uint16_t(tickUs > UINT16_MAX ? UINT16_MAX : tickUs);
+    BlackBox_record(s);
+}
+
+// periods > 1: deadlines were missed; the step runs once and the weapon
+// ramp catches up over the whole elapsed time
+static void controlTick(uint32_t periods) {
+    PERF_SCOPE(PerfId::CONTROL_TICK);
+    uint32_t startUs = Hal_micros();
+    recordTick(startUs, periods);
+
+    unsigned long nowMs = Hal_millis();
+    uint32_t dtUs = periods * CONTROL_PERIOD_US;
+
+    ControlQueue_apply();
+
+    {
+        PERF_SCOPE(PerfId::DRIVE_UPDATE);
+        Drive_update();
+    }
+    {
+        PERF_SCOPE(PerfId::WEAPON_UPDATE);
+        Weapon_updateArming(nowMs);
+        Weapon_update(dtUs, nowMs);
+    }
+    {
+        PERF_SCOPE(PerfId::FAILSAFE_UPDATE);
+        Failsafe_update(nowMs);
+    }
+    recordBlackBox(startUs);
+}
+
+void ControlLoop_init() {
+    ControlQueue_init();
+    resetRequested.store(true, std::memory_order_relaxed);
+    haveLastTick = false;
+}
+
+void ControlLoop_start() {
+    Hal_startPeriodicTask("control", controlTick, CONTROL_PERIOD_US,
+                          CONTROL_TASK_CORE, CONTROL_TASK_PRIORITY);
+}
+
+void ControlLoop_getStats(ControlLoopStats &out) {
+    out.ticks       = statTicks.load(std::memory_order_relaxed);
+    out.periodMinUs = out.ticks ? statPeriodMinUs.load(std::memory_order_relaxed) : 0;
+    out.periodMaxUs = statPeriodMaxUs.load(std::memory_order_relaxed);
+    out.jitterMaxUs = statJitterMaxUs.load(std::memory_order_relaxed);
+    out.jitterAvgUs = out.ticks ? statJitterSumUs.load(std::memory_order_relaxed) / out.ticks : 0;
+    out.missedDeadlines = statMissed.load(std::memory_order_relaxed);
+}
+
+void ControlLoop_resetStats() {
+    resetRequested.store(true, std::memory_order_relaxed);
+}
+
+void ControlLoop_dump(Print &p) {
+    ControlLoopStats s;
+    ControlLoop_getStats(s);
+    p.print(F("[CT] ticks="));
+    p.print(s.ticks);
+    p.print(F(" period="));
+    p.print(s.periodMinUs);
+    p.print(F(".."));
+    p.print(s.periodMaxUs);
+    p.print(F("us jitter avg="));
+    p.print(s.jitterAvgUs);
+    p.print(F("us max="));
+    p.print(s.jitterMaxUs);
+    p.print(F("us missed="));
+    p.println(s.missedDeadlines);
+}
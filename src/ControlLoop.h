@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Deterministic control tick: applies queued commands, then runs Drive,
+// Weapon and Failsafe every CONTROL_PERIOD_US in its own task pinned to
+// CONTROL_TASK_CORE, released by a microsecond timer. Transport ingestion, parsing, LEDs and logging stay in
+// loop() on the other core and reach this task only through ControlQueue.
+
+struct ControlLoopStats {
+    uint32_t ticks;
+    uint32_t periodMinUs;    // tick-to-tick interval
+    uint32_t periodMaxUs;
+    uint32_t jitterAvgUs;    // mean |interval - expected interval|
+    uint32_t jitterMaxUs;
+    uint32_t missedDeadlines;  // timer periods that passed without a tick
+};
+
+void ControlLoop_init();
+void ControlLoop_start();
+
+void ControlLoop_getStats(ControlLoopStats &out);
+void ControlLoop_resetStats();     // any core; applied on the next tick
+void ControlLoop_dump(Print &p);
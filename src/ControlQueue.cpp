@@ -0,0 +1,45 @@
+#include "ControlQueue.h"
+#include "SpscQueue.h"
+#include "Drive.h"
+#include "Weapon.h"
+#include "WeaponRamp.h"
+#include "Diagnostics.h"
+
+static SpscQueue<ControlCmd, CONTROL_QUEUE_SIZE> queue;
+
+void ControlQueue_init() {
+    queue.reset();
+}
+
+bool ControlQueue_post(ControlCmdType type, int a, int b, uint32_t rxUs) {
+    ControlCmd cmd;
+    cmd.type = type;
+    cmd.a = int16_t(a);
+    cmd.b = int16_t(b);
+    cmd.rxUs = rxUs;
+    if (!queue.push(cmd)) {
+        Diag_inc(DiagId::CONTROL_QUEUE_DROP);
+        return false;
+    }
+    return true;
+}
+
+uint8_t ControlQueue_apply() {
+    ControlCmd cmd;
+    uint8_t applied = 0;
+    while (queue.pop(cmd)) {
+        switch (cmd.type) {
+            case ControlCmdType::DRIVE:         Drive_setTargets(cmd.a, cmd.b, cmd.rxUs); break;
+            case ControlCmdType::WEAPON_ARM:    Weapon_armRequest(cmd.rxUs);   break;
+            case ControlCmdType::WEAPON_DISARM: Weapon_disarm(cmd.rxUs);       break;
+            case ControlCmdType::WEAPON_FULL:   Weapon_fullThrottle(cmd.rxUs); break;
+            case ControlCmdType::WEAPON_IDLE:   Weapon_idle(cmd.rxUs);         break;
+            case ControlCmdType::WEAPON_THROTTLE: Weapon_setThrottle(cmd.a, cmd.rxUs); break;
+            case ControlCmdType::ESC_PROTOCOL:  Weapon_setEscProtocol(EscProtocol(cmd.a)); break;
+            case ControlCmdType::RAMP_PROFILE:  WeaponRamp_setProfile(cmd.a != 0, RampProfile(cmd.b)); break;
+            case ControlCmdType::RAMP_POINT:    WeaponRamp_setTablePoint(uint8_t(cmd.a), uint16_t(cmd.b)); break;
+        }
+        applied++;
+    }
+    return applied;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Latency.h"
+
+// Commands from the comms side (parser) to the control task.
+// The parser never touches Drive/Weapon directly; it posts here and the
+// control task applies everything queued at the start of its next tick.
+
+constexpr uint16_t CONTROL_QUEUE_SIZE = 16;   // power of two
+
+enum class ControlCmdType : uint8_t {
+    DRIVE,           // a = left, b = right (±MAX_PWM)
+    WEAPON_ARM,
+    WEAPON_DISARM,
+    WEAPON_FULL,
+    WEAPON_IDLE,
+    WEAPON_THROTTLE, // a = setpoint in µs (ESC_ARM_US..ESC_MAX_US)
+    ESC_PROTOCOL,    // a = EscProtocol
+    RAMP_PROFILE,    // a = 1 up / 0 down, b = RampProfile
+    RAMP_POINT       // a = table index, b = permille
+};
+
+struct ControlCmd {
+    ControlCmdType type;
+    int16_t a;
+    int16_t b;
+    uint32_t rxUs;   // framing time of the source line, LATENCY_NO_STAMP if none
+};
+
+void ControlQueue_init();
+
+// Comms side: false (and Diag controlQueueDrops) when the queue is full
+bool ControlQueue_post(ControlCmdType type, int a = 0, int b = 0, uint32_t rxUs = LATENCY_NO_STAMP);
+
+// Control side: applies all queued commands, returns how many
+uint8_t ControlQueue_apply();
@@ -1,31 +1,32 @@
 #include "DebugIO.h"
 #include "Config.h"
+#include "Hal.h"
 
 void DebugIO_init() {
-    pinMode(PIN_DBG_INPUT,  OUTPUT);
-    pinMode(PIN_DBG_LEFT,   OUTPUT);
-    pinMode(PIN_DBG_RIGHT,  OUTPUT);
-    pinMode(PIN_DBG_WEAPON, OUTPUT);
+    Hal_pinOutput(PIN_DBG_INPUT);
+    Hal_pinOutput(PIN_DBG_LEFT);
+    Hal_pinOutput(PIN_DBG_RIGHT);
+    Hal_pinOutput(PIN_DBG_WEAPON);
 
-    digitalWrite(PIN_DBG_INPUT,  LOW);
-    digitalWrite(PIN_DBG_LEFT,   LOW);
-    digitalWrite(PIN_DBG_RIGHT,  LOW);
-    digitalWrite(PIN_DBG_WEAPON, LOW);
+    Hal_digitalWrite(PIN_DBG_INPUT,  false);
+    Hal_digitalWrite(PIN_DBG_LEFT,   false);
+    Hal_digitalWrite(PIN_DBG_RIGHT,  false);
+    Hal_digitalWrite(PIN_DBG_WEAPON, false);
 }
 
 void DebugIO_pulseInput() {
-    digitalWrite(PIN_DBG_INPUT, HIGH);
-    digitalWrite(PIN_DBG_INPUT, LOW);
+    Hal_digitalWrite(PIN_DBG_INPUT, true);
+    Hal_digitalWrite(PIN_DBG_INPUT, false);
 }
 
 void DebugIO_setLeftForward(bool forward) {
-    digitalWrite(PIN_DBG_LEFT, forward ? HIGH : LOW);
+    Hal_digitalWrite(PIN_DBG_LEFT, forward);
 }
 
 void DebugIO_setRightForward(bool forward) {
-    digitalWrite(PIN_DBG_RIGHT, forward ? HIGH : LOW);
+    Hal_digitalWrite(PIN_DBG_RIGHT, forward);
 }
 
 void DebugIO_setWeaponActive(bool active) {
-    digitalWrite(PIN_DBG_WEAPON, active ? HIGH : LOW);
+    Hal_digitalWrite(PIN_DBG_WEAPON, active);
 }
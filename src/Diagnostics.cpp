@@ -1,51 +1,51 @@
 #include "Diagnostics.h"
-#include <string.h>
+#include <atomic>
 
-static DiagnosticsCounters g_diag;
-static unsigned long g_lastPrintMs = 0;
-static DiagnosticsCounters g_lastPrinted; // zum Erkennen von Änderungen
+static std::atomic<uint32_t> g_counters[uint8_t(DiagId::COUNT)];
+static uint32_t g_lastDumped[uint8_t(DiagId::COUNT)];   // nur Comms-Core (DIAG?)
+
+#define DIAG_NAME_ENTRY(id, name) #name,
+static const char *const g_names[] = {
+    DIAG_COUNTERS(DIAG_NAME_ENTRY)
+};
+#undef DIAG_NAME_ENTRY
+
+static_assert(sizeof(g_names) / sizeof(g_names[0]) == uint8_t(DiagId::COUNT), "DIAG_COUNTERS names out of sync");
 
 void Diag_init() {
-    g_diag = DiagnosticsCounters{};
-    g_lastPrinted = g_diag;
-    g_lastPrintMs = 0;
+    for (uint8_t i = 0; i < uint8_t(DiagId::COUNT); i++) {
+        g_counters[i].store(0, std::memory_order_relaxed);
+        g_lastDumped[i] = 0;
+    }
+}
+
+void Diag_inc(DiagId id, uint32_t n) {
+    g_counters[uint8_t(id)].fetch_add(n, std::memory_order_relaxed);
 }
 
-#define DIAG_INC(field) do { g_diag.field++; } while(0)
-
-void Diag_incInvalidMotionFormat()   { DIAG_INC(invalidMotionFormat); }
-void Diag_incInvalidFunctionFormat() { DIAG_INC(invalidFunctionFormat); }
-void Diag_incInvalidMoveDir()        { DIAG_INC(invalidMoveDir); }
-void Diag_incInvalidSteerDir()       { DIAG_INC(invalidSteerDir); }
-void Diag_incBtBufferOverflow()      { DIAG_INC(btBufferOverflow); }
-void Diag_incMotionTimeout()         { DIAG_INC(motionTimeouts); }
-void Diag_incLinkTimeout()           { DIAG_INC(linkTimeouts); }
-void Diag_incWeaponArmingTimeout()   { DIAG_INC(weaponArmingTimeout); }
-void Diag_incInvalidLedCommand()     { DIAG_INC(invalidLedCommand); }
-void Diag_incLedShowOverrun()        { DIAG_INC(ledShowOverrun); }
-
-static bool countersChanged() {
-    return memcmp(&g_diag, &g_lastPrinted, sizeof(DiagnosticsCounters)) != 0;
+uint32_t Diag_get(DiagId id) {
+    return g_counters[uint8_t(id)].load(std::memory_order_relaxed);
 }
 
-void Diag_update(unsigned long nowMs) {
-    // Nur ca. 1x pro Sekunde prüfen/loggen
-    if (nowMs - g_lastPrintMs < 1000UL) return;
-    g_lastPrintMs = nowMs;
-
-    if (!countersChanged()) return;
-
-    Serial.println(F("[DIAG] Counters:"));
-    Serial.print(F("  invalidMotionFormat   = ")); Serial.println(g_diag.invalidMotionFormat);
-    Serial.print(F("  invalidFunctionFormat = ")); Serial.println(g_diag.invalidFunctionFormat);
-    Serial.print(F("  invalidMoveDir        = ")); Serial.println(g_diag.invalidMoveDir);
-    Serial.print(F("  invalidSteerDir       = ")); Serial.println(g_diag.invalidSteerDir);
-    Serial.print(F("  btBufferOverflow      = ")); Serial.println(g_diag.btBufferOverflow);
-    Serial.print(F("  motionTimeouts        = ")); Serial.println(g_diag.motionTimeouts);
-    Serial.print(F("  linkTimeouts          = ")); Serial.println(g_diag.linkTimeouts);
-    Serial.print(F("  weaponArmingTimeout   = ")); Serial.println(g_diag.weaponArmingTimeout);
-    Serial.print(F("  invalidLedCommand     = ")); Serial.println(g_diag.invalidLedCommand);
-    Serial.print(F("  ledShowOverrun        = ")); Serial.println(g_diag.ledShowOverrun);
-
-    g_lastPrinted = g_diag;
+void Diag_dump(Print &p) {
+    bool any = false;
+    p.print(F("[DIAG]"));
+    for (uint8_t i = 0; i < uint8_t(DiagId::COUNT); i++) {
+        uint32_t value = g_counters[i].load(std::memory_order_relaxed);
+        uint32_t delta = value - g_lastDumped[i];
+        g_lastDumped[i] = value;
+        if (value == 0) continue;
+
+        any = true;
+        p.print(' ');
+        p.print(g_names[i]);
+        p.print('=');
+        p.print(value);
+        if (delta != 0) {
+            p.print(F("(+"));
+            p.print(delta);
+            p.print(')');
+        }
+    }
+    p.println(any ? F("") : F(" all zero"));
 }
@@ -1,31 +1,38 @@
 #pragma once
 #include <Arduino.h>
 
-// einfache Fehlerzähler-Struktur
-struct DiagnosticsCounters {
-    uint32_t invalidMotionFormat   = 0;
-    uint32_t invalidFunctionFormat = 0;
-    uint32_t invalidMoveDir        = 0;
-    uint32_t invalidSteerDir       = 0;
-    uint32_t btBufferOverflow      = 0;
-    uint32_t motionTimeouts        = 0;
-    uint32_t linkTimeouts          = 0;
-    uint32_t weaponArmingTimeout   = 0;
-    uint32_t invalidLedCommand     = 0;
-    uint32_t ledShowOverrun        = 0;
+// Fehlerzähler, eine Zeile pro Zähler: X(Id, Name im DIAG?-Report)
+// Zählen geht von jedem Task/Core aus (relaxed atomic), gelesen wird nur
+// über DIAG? vom Comms-Core.
+#define DIAG_COUNTERS(X)                                  \
+    X(INVALID_MOTION_FORMAT,   invalidMotionFormat)       \
+    X(INVALID_FUNCTION_FORMAT, invalidFunctionFormat)     \
+    X(INVALID_MOVE_DIR,        invalidMoveDir)            \
+    X(INVALID_STEER_DIR,       invalidSteerDir)           \
+    X(BT_BUFFER_OVERFLOW,      btBufferOverflow)          \
+    X(MOTION_TIMEOUT,          motionTimeouts)            \
+    X(LINK_TIMEOUT,            linkTimeouts)              \
+    X(WEAPON_ARMING_TIMEOUT,   weaponArmingTimeout)       \
+    X(INVALID_LED_COMMAND,     invalidLedCommand)         \
+    X(LED_SHOW_OVERRUN,        ledShowOverrun)            \
+    X(COALESCED_COMMAND,       coalescedCommands)         \
+    X(BINARY_FRAME_ERROR,      binaryFrameErrors)         \
+    X(BINARY_SEQ_GAP,          binarySeqGaps)             \
+    X(CONTROL_QUEUE_DROP,      controlQueueDrops)         \
+    X(LOOP_OVERRUN,            loopOverruns)              \
+    X(ESC_PROTOCOL_FAILED,     escProtocolFailures)
+
+#define DIAG_ENUM_ENTRY(id, name) id,
+enum class DiagId : uint8_t {
+    DIAG_COUNTERS(DIAG_ENUM_ENTRY)
+    COUNT
 };
+#undef DIAG_ENUM_ENTRY
 
 void Diag_init();
-void Diag_incInvalidMotionFormat();
-void Diag_incInvalidFunctionFormat();
-void Diag_incInvalidMoveDir();
-void Diag_incInvalidSteerDir();
-void Diag_incBtBufferOverflow();
-void Diag_incMotionTimeout();
-void Diag_incLinkTimeout();
-void Diag_incWeaponArmingTimeout();
-void Diag_incInvalidLedCommand();
-void Diag_incLedShowOverrun();
+void Diag_inc(DiagId id, uint32_t n = 1);
+uint32_t Diag_get(DiagId id);
 
-// optional: Einmal pro Sekunde eine kompakte Übersicht ausgeben
-void Diag_update(unsigned long nowMs);
+// DIAG?: eine Zeile mit allen Zählern ungleich 0 und der Änderung seit dem
+// letzten Aufruf, z. B. "[DIAG] coalescedCommands=12(+3) linkTimeouts=1"
+void Diag_dump(Print &p);
@@ -2,8 +2,11 @@
 
 #include <Arduino.h>
 #include "State.h"
+#include "Latency.h"
 
 void Drive_init();
-void Drive_setTargets(int left, int right);  // Werte: -255..+255
+void Drive_setTargets(int left, int right,       // Werte: -MAX_PWM..+MAX_PWM
+                      uint32_t rxUs = LATENCY_NO_STAMP);
 void Drive_update();
 BotState Drive_getState();
+void Drive_getTargets(int &left, int &right);   // nur Control-Task
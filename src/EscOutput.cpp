@@ -0,0 +1,130 @@
+#include "EscOutput.h"
+#include "Hal.h"
+#include <atomic>
+
+constexpr uint32_t LEDC_CLOCK_HZ = 80000000UL;   // APB
+constexpr uint8_t  ESC_MAX_RES_BITS = 16;
+
+constexpr uint16_t DSHOT_MIN_THROTTLE = 48;      // 0..47 = special commands
+constexpr uint16_t DSHOT_MAX_THROTTLE = 2047;
+
+struct EscProtocolInfo {
+    const char *name;
+    uint32_t freqHz;        // analog: pulse repetition rate
+    int32_t  nsPerUs;       // pulse length = us * nsPerUs + offsetNs
+    int32_t  offsetNs;
+    uint16_t dshotKbps;     // 0 = analog (LEDC)
+};
+
+static const EscProtocolInfo PROTOCOLS[uint8_t(EscProtocol::COUNT)] = {
+    {"PWM50",    WEAPON_PWM_FREQ, 1000,      0,   0},
+    {"PWM400",   400,             1000,      0,   0},
+    {"OS125",    2000,            125,       0,   0},
+    {"MULTI",    16000,           20,   -15000,   0},   // 1000 us -> 5 us, 2000 us -> 25 us
+    {"DSHOT300", 0,               0,         0, 300},
+    {"DSHOT600", 0,               0,         0, 600},
+};
+
+static std::atomic<EscProtocol> protocol(EscProtocol::PWM50);   // ESC? reads it from the comms side
+static bool dshot = false;
+
+// value = (us * mulQ16 + addQ16) >> 16, set up by selectProtocol()
+static int64_t mulQ16 = 0;
+static int64_t addQ16 = 0;
+static int minUs = ESC_OFF_US;     // DShot: below this -> 0 (motor stop)
+
+static uint8_t resolutionFor(uint32_t freqHz) {
+    uint8_t bits = 0;
+    while (bits < ESC_MAX_RES_BITS && (uint64_t(freqHz) << (bits + 1)) <= LEDC_CLOCK_HZ) bits++;
+    return bits;
+}
+
+static uint16_t dshotFrame(uint16_t value) {
+    uint16_t packet = uint16_t(value << 1);          // telemetry bit = 0
+    uint16_t crc = (packet ^ (packet >> 4) ^ (packet >> 8)) & 0x0F;
+    return uint16_t((packet << 4) | crc);
+}
+
+// false: the DShot backend did not start, PWM50 is running instead
+static bool selectProtocol(EscProtocol p) {
+    const EscProtocolInfo &info = PROTOCOLS[uint8_t(p)];
+
+    // Leave the previous backend
+    if (dshot) {
+        Hal_dshotEnd(PIN_WEAPON);
+    } else {
+        Hal_pwmDetach(PIN_WEAPON);
+    }
+
+    protocol = p;
+    dshot = info.dshotKbps != 0;
+
+    if (dshot) {
+        // ESC_ARM_US..ESC_MAX_US -> 48..2047, rounded
+        minUs = ESC_ARM_US;
+        mulQ16 = (int64_t(DSHOT_MAX_THROTTLE - DSHOT_MIN_THROTTLE) << 16) / (ESC_MAX_US - ESC_ARM_US);
+        addQ16 = (int64_t(DSHOT_MIN_THROTTLE) << 16) - mulQ16 * ESC_ARM_US + (1 << 15);
+        if (!Hal_dshotBegin(PIN_WEAPON, info.dshotKbps)) {
+            dshot = false;   // nothing to end, the pin is free for LEDC
+            selectProtocol(EscProtocol::PWM50);
+            return false;
+        }
+    } else {
+        // duty = pulseNs * maxDuty / periodNs, rounded
+        uint8_t res = resolutionFor(info.freqHz);
+        int64_t maxDuty = (int64_t(1) << res) - 1;
+        int64_t periodNs = 1000000000LL / info.freqHz;
+        minUs = 0;
+        mulQ16 = (int64_t(info.nsPerUs) * maxDuty << 16) / periodNs;
+        addQ16 = (int64_t(info.offsetNs) * maxDuty << 16) / periodNs + (1 << 15);
+        Hal_pwmSetup(WEAPON_CHANNEL, info.freqHz, res);
+        Hal_pwmAttach(PIN_WEAPON, WEAPON_CHANNEL);
+    }
+    return true;
+}
+
+bool EscOutput_init(EscProtocol p) {
+    dshot = false;
+    bool ok = selectProtocol(p);
+    EscOutput_writeUs(ESC_OFF_US);
+    return ok;
+}
+
+bool EscOutput_setProtocol(EscProtocol p) {
+    if (uint8_t(p) >= uint8_t(EscProtocol::COUNT)) return false;
+    bool ok = selectProtocol(p);
+    EscOutput_writeUs(ESC_OFF_US);
+    return ok;
+}
+
+EscProtocol EscOutput_getProtocol() {
+    return protocol;
+}
+
+void EscOutput_writeUs(int us) {
+    if (dshot) {
+        uint16_t value = 0;
+        if (us >= minUs) {
+            int64_t v = (int64_t(us) * mulQ16 + addQ16) >> 16;
+            value = uint16_t(v > DSHOT_MAX_THROTTLE ? DSHOT_MAX_THROTTLE : v);
+        }
+        Hal_dshotWrite(dshotFrame(value));
+    } else {
+        int64_t duty = (int64_t(us) * mulQ16 + addQ16) >> 16;
+        Hal_pwmWrite(WEAPON_CHANNEL, uint32_t(duty < 0 ? 0 : duty));
+    }
+}
+
+const char *EscOutput_protocolName(EscProtocol p) {
+    return uint8_t(p) < uint8_t(EscProtocol::COUNT) ? PROTOCOLS[uint8_t(p)].name : "?";
+}
+
+bool EscOutput_parseProtocol(const char *name, size_t len, EscProtocol &out) {
+    for (uint8_t i = 0; i < uint8_t(EscProtocol::COUNT); i++) {
+        if (strlen(PROTOCOLS[i].name) == len && memcmp(PROTOCOLS[i].name, name, len) == 0) {
+            out = EscProtocol(i);
+            return true;
+        }
+    }
+    return false;
+}
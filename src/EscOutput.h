@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Weapon ESC output backend. Takes the throttle on the classic pulse scale
+// (ESC_OFF_US..ESC_MAX_US) and emits it in the selected protocol:
+// LEDC PWM for the analog protocols, RMT loop mode for DShot. All scaling
+// factors are precomputed when the protocol is selected; writeUs() is an
+// integer multiply-shift.
+// Control task only (getProtocol/names: any task).
+
+// Both re-init the pin with output = ESC_OFF_US. false: the protocol could
+// not be started (DShot without a free RMT channel); PWM50 runs instead.
+bool EscOutput_init(EscProtocol protocol);
+bool EscOutput_setProtocol(EscProtocol protocol);
+EscProtocol EscOutput_getProtocol();
+
+void EscOutput_writeUs(int us);
+
+const char *EscOutput_protocolName(EscProtocol protocol);
+bool EscOutput_parseProtocol(const char *name, size_t len, EscProtocol &out);
@@ -3,14 +3,19 @@
 #include "Drive.h"
 #include "Weapon.h"
 #include "Diagnostics.h"
+#include "BlackBox.h"
+#include "Hal.h"
+#include "Log.h"
+#include <atomic>
 
-static unsigned long g_lastMotionMs  = 0;
-static unsigned long g_lastAnyCmdMs  = 0;
-static bool g_motionTimeoutActive    = false;
-static bool g_linkTimeoutActive      = false;
+// on*Command() kommt vom Parser (Comms-Core), update() vom Control-Task
+static std::atomic<unsigned long> g_lastMotionMs(0);
+static std::atomic<unsigned long> g_lastAnyCmdMs(0);
+static std::atomic<bool> g_motionTimeoutActive(false);
+static std::atomic<bool> g_linkTimeoutActive(false);
 
 void Failsafe_init() {
-    unsigned long now = millis();
+    unsigned long now = Hal_millis();
     g_lastMotionMs     = now;
     g_lastAnyCmdMs     = now;
     g_motionTimeoutActive = false;
@@ -22,6 +27,7 @@ void Failsafe_onMotionCommand(unsigned long nowMs) {
     g_motionTimeoutActive = false; // Reset, sobald wieder Kommando kommt
 }
 
+// Reihenfolge zählt: Zeitstempel vor dem Flag (siehe Failsafe_update)
 void Failsafe_onAnyCommand(unsigned long nowMs) {
     g_lastAnyCmdMs = nowMs;
     g_linkTimeoutActive = false;
@@ -29,16 +35,26 @@ void Failsafe_onAnyCommand(unsigned long nowMs) {
 
 void Failsafe_update(unsigned long nowMs) {
     // Nur Link-Failsafe aktiv: Waffe in Idle, wenn lange kein Kommando (motion ODER function)
-    if (!g_linkTimeoutActive &&
-        (nowMs - g_lastAnyCmdMs) > FAILSAFE_LINK_TIMEOUT_MS) {
+    // Erst das Flag, dann den Zeitstempel laden: onAnyCommand() schreibt in
+    // umgekehrter Reihenfolge, ein gelöschtes Flag bringt also immer den
+    // frischen Zeitstempel mit (kein zweiter Timeout direkt nach einem Kommando)
+    bool timeoutActive = g_linkTimeoutActive.load();
+    // signed: der Zeitstempel des anderen Cores kann minimal vor nowMs liegen
+    long sinceAnyMs = long(nowMs - g_lastAnyCmdMs.load());
+    if (!timeoutActive && sinceAnyMs > long(FAILSAFE_LINK_TIMEOUT_MS)) {
 
         if (Weapon_getState() == WeaponState::ARMED) {
             Weapon_idle();
         }
 
-        Diag_incLinkTimeout();
+        Diag_inc(DiagId::LINK_TIMEOUT);
         g_linkTimeoutActive = true;
+        BlackBox_trigger();
 
-        Serial.println(F("[FS] Link timeout -> weapon idle"));
+        LOG_WRN("[FS] Link timeout -> weapon idle");
     }
 }
+
+bool Failsafe_isLinkTimeout() {
+    return g_linkTimeoutActive;
+}
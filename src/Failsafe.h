@@ -12,3 +12,6 @@ void Failsafe_onAnyCommand(unsigned long nowMs);
 
 // im festen Loop-Takt aufrufen
 void Failsafe_update(unsigned long nowMs);
+
+// true, solange der Link-Timeout ausgelöst ist (bis zum nächsten Kommando)
+bool Failsafe_isLinkTimeout();
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Thin hardware abstraction layer.
+// All modules talk to clock, GPIO, LEDC/PWM, serial transports and the pixel
+// strip only through these functions. HalEsp32.cpp maps them onto the Arduino
+// core, native/HalNative.cpp onto a simulated clock and recording sinks.
+
+// --- Clock ---
+uint32_t Hal_millis();
+uint32_t Hal_micros();
+
+// Free-running cycle counter for short measurements (wraps, use differences).
+// ESP32: CPU cycles; host: nanoseconds of a monotonic clock (1000 "MHz").
+uint32_t Hal_cycleCount();
+uint32_t Hal_cycleFreqMHz();
+
+// --- Tasks ---
+// periods = timer periods since the last call: 1 normally, >1 when the task
+// missed deadlines (it is then called once and should catch up).
+typedef void (*HalTickFn)(uint32_t periods);
+
+// Runs fn every periodUs in its own task pinned to core. ESP32: an esp_timer
+// notifies the task, so the release time has microsecond resolution and does
+// not drift with the 1 ms FreeRTOS tick. The Arduino loop() keeps running on
+// the other core.
+void Hal_startPeriodicTask(const char *name, HalTickFn fn, uint32_t periodUs,
+                           uint8_t core, uint8_t priority);
+
+// --- GPIO ---
+void Hal_pinOutput(int pin);
+void Hal_digitalWrite(int pin, bool high);
+
+// --- LEDC / PWM ---
+void Hal_pwmSetup(uint8_t channel, uint32_t freqHz, uint8_t resBits);
+void Hal_pwmAttach(int pin, uint8_t channel);
+void Hal_pwmWrite(uint8_t channel, uint32_t duty);
+void Hal_pwmDetach(int pin);
+
+// Writes several duty registers, then latches them in the given order. The
+// latches are separate register writes, so a period boundary can fall
+// between two of them: a channel never switches later than one listed
+// after it, but may switch one PWM period earlier. Callers list channels
+// that must be released first (break-before-make) at the front.
+void Hal_pwmWriteSync(const uint8_t *channels, const uint32_t *duties, uint8_t count);
+
+// --- DShot output (RMT) ---
+// Loop mode: the last written 16-bit frame (value, telemetry bit, CRC) is
+// repeated back-to-back with a short pause until the next write.
+bool Hal_dshotBegin(int pin, uint16_t kbps);
+void Hal_dshotWrite(uint16_t frame);
+void Hal_dshotEnd(int pin);
+
+// --- Serial transports (command input) ---
+enum class HalTransport : uint8_t {
+    USB,    // USB Serial (Tisch/Tuning)
+    BT,     // Bluetooth SPP (App)
+    COUNT
+};
+
+void Hal_btBegin(const char *deviceName);
+int  Hal_transportAvailable(HalTransport t);
+int  Hal_transportRead(HalTransport t);      // -1 if nothing available
+
+// --- Pixel strip (WS2812B, GRB) ---
+// Set/Clear write a render buffer. Show copies it into the transmit buffer
+// and starts sending in the background, so rendering the next frame overlaps
+// transmission. Returns false (frame not taken, render buffer untouched)
+// while the previous frame is still on the wire; call again later.
+// Pixels are sent as given (gamma/brightness is applied by LedGamma); Set
+// returns true if the pixel changed.
+void Hal_pixelsBegin(uint16_t count, int pin);
+bool Hal_pixelsSet(uint16_t idx, uint32_t rgb);
+void Hal_pixelsClear();
+bool Hal_pixelsShow();
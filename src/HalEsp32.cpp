@@ -0,0 +1,290 @@
+#include "Hal.h"
+#include <Arduino.h>
+#include <BluetoothSerial.h>
+#include <Adafruit_NeoPixel.h>
+#include <esp_timer.h>
+#include <driver/rmt.h>
+#include <soc/ledc_struct.h>
+
+static BluetoothSerial SerialBT;
+static Adafruit_NeoPixel strip;
+
+// --- Clock ---
+uint32_t Hal_millis() { return millis(); }
+uint32_t Hal_micros() { return micros(); }
+uint32_t Hal_cycleCount() { return ESP.getCycleCount(); }
+uint32_t Hal_cycleFreqMHz() { return getCpuFrequencyMhz(); }
+
+// --- Tasks ---
+struct PeriodicTask {
+    HalTickFn fn;
+    TaskHandle_t handle;
+    esp_timer_handle_t timer;
+};
+
+// esp_timer task context: only wakes the worker, notifications accumulate
+// while it is still busy
+static void periodicTimerCallback(void *arg) {
+    PeriodicTask *task = static_cast<PeriodicTask *>(arg);
+    xTaskNotifyGive(task->handle);
+}
+
+static void periodicTaskEntry(void *arg) {
+    const PeriodicTask *task = static_cast<const PeriodicTask *>(arg);
+    for (;;) {
+        uint32_t periods = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (periods > 0) task->fn(periods);
+    }
+}
+
+void Hal_startPeriodicTask(const char *name, HalTickFn fn, uint32_t periodUs,
+                           uint8_t core, uint8_t priority) {
+    static PeriodicTask tasks[2];
+    static uint8_t taskCount = 0;
+    if (taskCount >= 2) return;
+
+    PeriodicTask *task = &tasks[taskCount++];
+    task->fn = fn;
+    xTaskCreatePinnedToCore(periodicTaskEntry, name, 4096, task, priority, &task->handle, core);
+
+    esp_timer_create_args_t args = {};
+    args.callback = periodicTimerCallback;
+    args.arg = task;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = name;
+    esp_timer_create(&args, &task->timer);
+    esp_timer_start_periodic(task->timer, periodUs);
+}
+
+// --- GPIO ---
+void Hal_pinOutput(int pin) { pinMode(pin, OUTPUT); }
+void Hal_digitalWrite(int pin, bool high) { digitalWrite(pin, high ? HIGH : LOW); }
+
+// --- LEDC / PWM ---
+void Hal_pwmSetup(uint8_t channel, uint32_t freqHz, uint8_t resBits) {
+    ledcSetup(channel, freqHz, resBits);
+}
+
+void Hal_pwmAttach(int pin, uint8_t channel) {
+    ledcAttachPin(pin, channel);
+}
+
+void Hal_pwmWrite(uint8_t channel, uint32_t duty) {
+    ledcWrite(channel, duty);
+}
+
+void Hal_pwmDetach(int pin) {
+    ledcDetachPin(pin);
+}
+
+// Direct register access (channels set up by ledcSetup: group = ch / 8).
+// All duty values are written first, then the start bits back to back in
+// list order. Each start bit is its own register write, so a timer overflow
+// can fall between two of them; an earlier channel then takes its new duty
+// one period before a later one, never after it.
+void Hal_pwmWriteSync(const uint8_t *channels, const uint32_t *duties, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        LEDC.channel_group[channels[i] / 8].channel[channels[i] % 8].duty.duty = duties[i] << 4;   // 4 fraction bits
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        auto &ch = LEDC.channel_group[channels[i] / 8].channel[channels[i] % 8];
+        ch.conf0.sig_out_en = 1;
+        // duty_start | duty_inc | duty_num = 1 | duty_cycle = 1 | duty_scale = 0
+        ch.conf1.val = (1UL << 31) | (1UL << 30) | (1UL << 20) | (1UL << 10);
+        if (channels[i] >= 8) ch.conf0.low_speed_update = 1;
+    }
+}
+
+// --- DShot output (RMT) ---
+// Channels 6 (pixels) and 7 stay clear of the NeoPixel fallback, which
+// allocates from 0 up.
+static const rmt_channel_t DSHOT_RMT_CHANNEL = RMT_CHANNEL_7;
+static const uint16_t DSHOT_PAUSE_TICKS = 800;      // 2 x 10 us low between frames
+
+static bool dshotActive = false;
+static uint16_t dshotBitTicks = 0;                  // 12.5 ns ticks (80 MHz, clk_div 1)
+
+bool Hal_dshotBegin(int pin, uint16_t kbps) {
+    rmt_config_t cfg = {};
+    cfg.rmt_mode = RMT_MODE_TX;
+    cfg.channel = DSHOT_RMT_CHANNEL;
+    cfg.gpio_num = gpio_num_t(pin);
+    cfg.clk_div = 1;
+    cfg.mem_block_num = 1;
+    cfg.tx_config.loop_en = true;
+    cfg.tx_config.carrier_en = false;
+    cfg.tx_config.idle_output_en = true;
+    cfg.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&cfg) != ESP_OK) return false;
+    if (rmt_driver_install(DSHOT_RMT_CHANNEL, 0, 0) != ESP_OK) return false;
+
+    dshotBitTicks = uint16_t(80000U / kbps);
+    dshotActive = true;
+    Hal_dshotWrite(0);
+    rmt_tx_start(DSHOT_RMT_CHANNEL, true);
+    return true;
+}
+
+// Rewrites the looping item buffer. A frame torn by the update fails the
+// DShot CRC and is ignored by the ESC; the next repetition is complete.
+void Hal_dshotWrite(uint16_t frame) {
+    if (!dshotActive) return;
+
+    const uint16_t t1h = uint16_t(dshotBitTicks * 3 / 4);
+    const uint16_t t0h = uint16_t(dshotBitTicks * 3 / 8);
+    rmt_item32_t items[18];
+    for (int i = 0; i < 16; i++) {
+        bool one = frame & (0x8000 >> i);
+        items[i].level0 = 1;
+        items[i].duration0 = one ? t1h : t0h;
+        items[i].level1 = 0;
+        items[i].duration1 = dshotBitTicks - items[i].duration0;
+    }
+    items[16].level0 = 0;
+    items[16].duration0 = DSHOT_PAUSE_TICKS;
+    items[16].level1 = 0;
+    items[16].duration1 = DSHOT_PAUSE_TICKS;
+    items[17].val = 0;   // end marker: loop restarts here
+    rmt_fill_tx_items(DSHOT_RMT_CHANNEL, items, 18, 0);
+}
+
+void Hal_dshotEnd(int /*pin*/) {
+    if (!dshotActive) return;
+    rmt_tx_stop(DSHOT_RMT_CHANNEL);
+    rmt_driver_uninstall(DSHOT_RMT_CHANNEL);
+    dshotActive = false;
+}
+
+// --- Serial transports ---
+void Hal_btBegin(const char *deviceName) {
+    SerialBT.begin(deviceName);
+}
+
+int Hal_transportAvailable(HalTransport t) {
+    switch (t) {
+        case HalTransport::USB: return Serial.available();
+        case HalTransport::BT:  return SerialBT.available();
+        default:                return 0;
+    }
+}
+
+int Hal_transportRead(HalTransport t) {
+    switch (t) {
+        case HalTransport::USB: return Serial.read();
+        case HalTransport::BT:  return SerialBT.read();
+        default:                return -1;
+    }
+}
+
+// --- Pixel strip ---
+// RMT channel 6 sends the transmit buffer (GRB bytes) while loop() goes on:
+// the driver's translator expands bytes into RMT items from its ISR, half a
+// memory block at a time, so starting a frame costs the same for any strip
+// length apart from the buffer copy. If the RMT driver cannot be installed,
+// Adafruit_NeoPixel takes over (blocking show, interrupts off).
+static const rmt_channel_t PIXEL_RMT_CHANNEL = RMT_CHANNEL_6;
+static const uint32_t PIXEL_RESET_US = 60;          // low time that latches a frame (> 50 us)
+
+// rmt_item32_t.val at 40 MHz (clk_div 2): duration0 | level0 << 15 | duration1 << 16 | level1 << 31
+// 0 bit: 0.40 us high, 0.85 us low; 1 bit: 0.80 us high, 0.45 us low
+static const uint32_t PIXEL_BIT0 = 16U | (1U << 15) | (34U << 16);
+static const uint32_t PIXEL_BIT1 = 32U | (1U << 15) | (18U << 16);
+
+static bool pixelRmt = false;
+static uint16_t pixelCount = 0;
+static uint8_t *pixelRender = nullptr;              // written by Hal_pixelsSet/Clear
+static uint8_t *pixelTx = nullptr;                  // read by the RMT ISR
+static volatile uint32_t pixelTxEndUs = 0;
+
+static void IRAM_ATTR pixelTranslate(const void *src, rmt_item32_t *dest, size_t srcSize,
+                                     size_t wantedNum, size_t *translatedSize, size_t *itemNum) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(src);
+    size_t size = 0;
+    size_t num = 0;
+    while (size < srcSize && num + 8 <= wantedNum) {
+        uint8_t b = bytes[size++];
+        for (uint8_t mask = 0x80; mask; mask >>= 1) {
+            dest[num++].val = (b & mask) ? PIXEL_BIT1 : PIXEL_BIT0;
+        }
+    }
+    *translatedSize = size;
+    *itemNum = num;
+}
+
+static void pixelTxEnd(rmt_channel_t channel, void * /*arg*/) {
+    if (channel == PIXEL_RMT_CHANNEL) pixelTxEndUs = micros();
+}
+
+static bool pixelRmtBegin(int pin) {
+    rmt_config_t cfg = {};
+    cfg.rmt_mode = RMT_MODE_TX;
+    cfg.channel = PIXEL_RMT_CHANNEL;
+    cfg.gpio_num = gpio_num_t(pin);
+    cfg.clk_div = 2;
+    cfg.mem_block_num = 1;
+    cfg.tx_config.loop_en = false;
+    cfg.tx_config.carrier_en = false;
+    cfg.tx_config.idle_output_en = true;
+    cfg.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&cfg) != ESP_OK) return false;
+    if (rmt_driver_install(PIXEL_RMT_CHANNEL, 0, 0) != ESP_OK) return false;
+    if (rmt_translator_init(PIXEL_RMT_CHANNEL, pixelTranslate) != ESP_OK) {
+        rmt_driver_uninstall(PIXEL_RMT_CHANNEL);
+        return false;
+    }
+    rmt_register_tx_end_callback(pixelTxEnd, nullptr);
+    return true;
+}
+
+void Hal_pixelsBegin(uint16_t count, int pin) {
+    pixelCount = count;
+    pixelRender = static_cast<uint8_t *>(calloc(size_t(count) * 3, 1));
+    pixelTx = static_cast<uint8_t *>(calloc(size_t(count) * 3, 1));
+    pixelRmt = pixelRender && pixelTx && pixelRmtBegin(pin);
+    if (pixelRmt) return;
+
+    strip.updateType(NEO_GRB + NEO_KHZ800);
+    strip.updateLength(count);
+    strip.setPin(pin);
+    strip.begin();     // brightness left at "no scaling"
+}
+
+bool Hal_pixelsSet(uint16_t idx, uint32_t rgb) {
+    uint8_t *p;
+    if (pixelRmt) {
+        if (idx >= pixelCount) return false;
+        p = pixelRender + size_t(idx) * 3;
+    } else {
+        if (idx >= strip.numPixels()) return false;
+        p = strip.getPixels() + size_t(idx) * 3;     // NEO_GRB: same byte order
+    }
+    uint8_t before[3] = {p[0], p[1], p[2]};
+    if (pixelRmt) {
+        p[0] = uint8_t(rgb >> 8);
+        p[1] = uint8_t(rgb >> 16);
+        p[2] = uint8_t(rgb);
+    } else {
+        strip.setPixelColor(idx, rgb);
+    }
+    return p[0] != before[0] || p[1] != before[1] || p[2] != before[2];
+}
+
+void Hal_pixelsClear() {
+    if (!pixelRmt) {
+        strip.clear();
+        return;
+    }
+    memset(pixelRender, 0, size_t(pixelCount) * 3);
+}
+
+bool Hal_pixelsShow() {
+    if (!pixelRmt) {
+        strip.show();
+        return true;
+    }
+    if (rmt_wait_tx_done(PIXEL_RMT_CHANNEL, 0) != ESP_OK) return false;      // still sending
+    if (micros() - pixelTxEndUs < PIXEL_RESET_US) return false;              // still latching
+    memcpy(pixelTx, pixelRender, size_t(pixelCount) * 3);
+    rmt_write_sample(PIXEL_RMT_CHANNEL, pixelTx, size_t(pixelCount) * 3, false);
+    return true;
+}
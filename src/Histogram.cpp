@@ -0,0 +1,47 @@
+#include "Histogram.h"
+#include <string.h>
+
+// Values 0..3 map directly, above that: octave * 4 + next two bits
+static uint8_t bucketOf(uint32_t v) {
+    if (v < (1U << HIST_SUB_BITS)) return uint8_t(v);
+    uint8_t msb = uint8_t(31 - __builtin_clz(v));
+    uint8_t sub = uint8_t((v >> (msb - HIST_SUB_BITS)) & ((1U << HIST_SUB_BITS) - 1));
+    return uint8_t(((msb - HIST_SUB_BITS + 1) << HIST_SUB_BITS) + sub);
+}
+
+// Largest value that still falls into bucket b
+static uint32_t bucketUpper(uint8_t b) {
+    if (b < (1U << HIST_SUB_BITS)) return b;
+    uint8_t msb = uint8_t((b >> HIST_SUB_BITS) + HIST_SUB_BITS - 1);
+    uint32_t sub = b & ((1U << HIST_SUB_BITS) - 1);
+    uint64_t lower = uint64_t((1U << HIST_SUB_BITS) + sub) << (msb - HIST_SUB_BITS);
+    uint64_t width = 1ULL << (msb - HIST_SUB_BITS);
+    uint64_t upper = lower + width - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : uint32_t(upper);
+}
+
+void Histogram_clear(Histogram &h) {
+    memset(&h, 0, sizeof(h));
+    h.min = UINT32_MAX;
+}
+
+void Histogram_add(Histogram &h, uint32_t v) {
+    h.count++;
+    h.sum += v;
+    if (v < h.min) h.min = v;
+    if (v > h.max) h.max = v;
+    h.buckets[bucketOf(v)]++;
+}
+
+uint32_t Histogram_percentile99(const Histogram &h) {
+    uint32_t rank = h.count - h.count / 100;          // ceil(0.99 * n)
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < HIST_BUCKETS; b++) {
+        seen += h.buckets[b];
+        if (seen >= rank) {
+            uint32_t upper = bucketUpper(b);
+            return upper < h.max ? upper : h.max;
+        }
+    }
+    return h.max;
+}
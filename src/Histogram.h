@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fixed-size log-scale histogram: 4 buckets per power of two, so p99 is
+// accurate to about 25%; min/avg/max are exact. Single writer; readers on
+// another task may see a snapshot that is off by one sample.
+
+constexpr uint8_t HIST_SUB_BITS = 2;                                  // 4 buckets per octave
+constexpr uint8_t HIST_BUCKETS  = (32 - HIST_SUB_BITS + 1) << HIST_SUB_BITS;
+
+struct Histogram {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t buckets[HIST_BUCKETS];
+};
+
+void     Histogram_clear(Histogram &h);
+void     Histogram_add(Histogram &h, uint32_t v);
+uint32_t Histogram_percentile99(const Histogram &h);   // bucket upper bound, at most max
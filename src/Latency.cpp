@@ -0,0 +1,64 @@
+#include "Latency.h"
+#include "Hal.h"
+#include "Perf.h"
+#include <atomic>
+
+static Histogram hist[uint8_t(LatencyId::COUNT)];
+static std::atomic<uint32_t> resetMask(0);
+
+static const char *const LATENCY_NAMES[uint8_t(LatencyId::COUNT)] = {
+    "drive", "weapon"
+};
+
+void Latency_init() {
+    for (uint8_t i = 0; i < uint8_t(LatencyId::COUNT); i++) Histogram_clear(hist[i]);
+    resetMask.store(0, std::memory_order_relaxed);
+}
+
+void Latency_record(LatencyId id, uint32_t rxUs) {
+#if PERF_ENABLED
+    if (rxUs == LATENCY_NO_STAMP) return;
+    uint8_t i = uint8_t(id);
+    uint32_t bit = 1UL << i;
+    if (resetMask.load(std::memory_order_relaxed) & bit) {
+        Histogram_clear(hist[i]);
+        resetMask.fetch_and(~bit, std::memory_order_relaxed);
+    }
+    Histogram_add(hist[i], Hal_micros() - rxUs);
+#else
+    (void)id;
+    (void)rxUs;
+#endif
+}
+
+void Latency_reset() {
+    resetMask.store((1UL << uint8_t(LatencyId::COUNT)) - 1, std::memory_order_relaxed);
+}
+
+void Latency_dump(Print &p) {
+#if PERF_ENABLED
+    bool any = false;
+    for (uint8_t i = 0; i < uint8_t(LatencyId::COUNT); i++) {
+        const Histogram &h = hist[i];
+        if (h.count == 0 || (resetMask.load(std::memory_order_relaxed) & (1UL << i))) continue;
+        any = true;
+
+        p.print(F("[LAT] "));
+        p.print(LATENCY_NAMES[i]);
+        p.print(F(" n="));
+        p.print(h.count);
+        p.print(F(" min="));
+        p.print(h.min);
+        p.print(F(" avg="));
+        p.print(uint32_t(h.sum / h.count));
+        p.print(F(" p99="));
+        p.print(Histogram_percentile99(h));
+        p.print(F(" max="));
+        p.print(h.max);
+        p.println(F(" us"));
+    }
+    if (!any) p.println(F("[LAT] no samples"));
+#else
+    p.println(F("[LAT] disabled (PERF_ENABLED=0)"));
+#endif
+}
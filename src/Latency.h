@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Histogram.h"
+
+// Command-to-actuator latency.
+// BluetoothComm stamps each line with Hal_micros() taken at the start of the
+// pump pass that read it (one stamp per pass, never later than reading the
+// line's last byte, so the recorded latency is an upper bound). The stamp
+// rides along through the parser and the ControlQueue to Drive/Weapon, which
+// record the time up to the control step that applied the command to the
+// output. Stamps use the global microsecond clock, so they
+// compare across cores. PERF_ENABLED=0 compiles recording out.
+
+constexpr uint32_t LATENCY_NO_STAMP = UINT32_MAX;   // command not from a transport
+
+enum class LatencyId : uint8_t {
+    DRIVE,     // motion command -> Drive_update wrote the H-bridge duties
+    WEAPON,    // weapon command -> Weapon_update wrote a changed ESC output
+    COUNT
+};
+
+void Latency_init();
+void Latency_record(LatencyId id, uint32_t rxUs);   // control task; ignores LATENCY_NO_STAMP
+void Latency_reset();                               // any task; cleared on the next record
+void Latency_dump(Print &p);
@@ -0,0 +1,216 @@
+#include "LedCompositor.h"
+#include "LedEffects.h"
+
+struct LedLayer {
+    LedLayerSpec spec;          // BASE/ALERT only; STATUS pixels come from Leds
+    LedPhase phase;
+    uint32_t remainingMs;       // ALERT: time until it ends, 0 = no expiry
+    uint16_t renderedKey;       // effect state the cached pixels were rendered for
+    uint8_t alpha;              // layer opacity
+    bool stale;                 // spec changed: re-render regardless of the key
+};
+
+static LedLayer layers[LED_ZONE_COUNT][LED_LAYER_COUNT];
+
+// Cached layer pixels (0xAARRGGBB); zones never overlap, so one strip-sized
+// buffer per layer holds every zone at its absolute position
+static uint32_t layerPixels[LED_LAYER_COUNT][LED_COUNT];
+static bool zoneDirty[LED_ZONE_COUNT];
+
+static const char *const zoneNames[LED_ZONE_COUNT] = {"left", "weapon", "right"};
+static const char *const fxNames[] = {"OFF", "SOLID", "BLINK", "PULSE", "WIPE"};
+
+static LedLayer &layerOf(LedZoneId zone, LedLayerId layer) {
+    return layers[uint8_t(zone)][uint8_t(layer)];
+}
+
+static void startPhase(LedLayer &l, const LedZone &zone) {
+    uint32_t cycleMs = l.spec.periodMs;
+    if (l.spec.fx == LedLayerFx::WIPE) cycleMs *= zone.count;   // periodMs is the step time per pixel
+    if (cycleMs < 2) cycleMs = 2;
+    LedPhase_start(l.phase, cycleMs);
+}
+
+// Effect state that decides the layer pixels; equal key = nothing to redraw
+static uint16_t effectKey(const LedLayer &l, const LedZone &zone) {
+    uint16_t phase88 = LedPhase_get88(l.phase);
+    switch (l.spec.fx) {
+        case LedLayerFx::BLINK: return phase88 < 0x8000 ? 1 : 0;
+        case LedLayerFx::PULSE: return LedFx_triangle(phase88);
+        case LedLayerFx::WIPE:  return LedFx_position(phase88, zone.count);
+        default:                return 0;
+    }
+}
+
+static void renderEffect(uint32_t *px, const LedLayer &l, const LedZone &zone, uint16_t key) {
+    uint32_t opaque = LED_ARGB_OPAQUE | l.spec.color;
+    uint32_t fill = 0;
+    switch (l.spec.fx) {
+        case LedLayerFx::SOLID: fill = opaque; break;
+        case LedLayerFx::BLINK: fill = key ? opaque : 0; break;
+        case LedLayerFx::PULSE: fill = (uint32_t(key) << 24) | l.spec.color; break;   // fades over the layers below
+        default: break;                                                             // OFF, WIPE: transparent
+    }
+    for (uint16_t i = zone.start; i < zone.end(); i++) px[i] = fill;
+    if (l.spec.fx == LedLayerFx::WIPE) px[zone.start + key] = opaque;
+}
+
+static void resetLayer(LedLayer &l) {
+    l.spec = {LedLayerFx::OFF, 0, 0};
+    l.phase = {0, 0};
+    l.remainingMs = 0;
+    l.renderedKey = 0;
+    l.alpha = 0xFF;
+    l.stale = true;
+}
+
+void LedComp_init() {
+    LedComp_reset();
+}
+
+// STATUS pixels stay: Leds only rewrites them when the bot state changes
+void LedComp_reset() {
+    for (uint8_t z = 0; z < LED_ZONE_COUNT; z++) {
+        for (uint8_t l = 0; l < LED_LAYER_COUNT; l++) resetLayer(layers[z][l]);
+        zoneDirty[z] = true;
+    }
+}
+
+void LedComp_redraw() {
+    const LedZoneMap &zones = LedZones_get();
+    for (uint8_t l = 0; l < LED_LAYER_COUNT; l++) {
+        for (uint16_t i = 0; i < LED_COUNT; i++) layerPixels[l][i] = 0;
+    }
+    for (uint8_t z = 0; z < LED_ZONE_COUNT; z++) {
+        for (uint8_t l = 0; l < LED_LAYER_COUNT; l++) {
+            startPhase(layers[z][l], zones.zones[z]);   // WIPE cycle depends on the zone size
+            layers[z][l].stale = true;
+        }
+        zoneDirty[z] = true;
+    }
+}
+
+void LedComp_setEffect(LedZoneId zone, LedLayerId layer, const LedLayerSpec &spec, uint32_t durationMs) {
+    if (layer == LedLayerId::STATUS) return;
+    LedLayer &l = layerOf(zone, layer);
+    l.spec = spec;
+    l.remainingMs = (layer == LedLayerId::ALERT && spec.fx != LedLayerFx::OFF) ? durationMs : 0;
+    l.stale = true;
+    startPhase(l, LedZones_get()[zone]);
+}
+
+void LedComp_setAlpha(LedZoneId zone, LedLayerId layer, uint8_t alpha) {
+    LedLayer &l = layerOf(zone, layer);
+    if (l.alpha == alpha) return;
+    l.alpha = alpha;
+    zoneDirty[uint8_t(zone)] = true;
+}
+
+void LedComp_statusFill(LedZoneId zone, uint16_t offset, uint16_t n, uint32_t argb) {
+    const LedZone &z = LedZones_get()[zone];
+    if (offset >= z.count) return;
+    if (n > z.count - offset) n = z.count - offset;
+
+    uint32_t *px = &layerPixels[uint8_t(LedLayerId::STATUS)][z.start + offset];
+    bool changed = false;
+    for (uint16_t i = 0; i < n; i++) {
+        if (px[i] == argb) continue;
+        px[i] = argb;
+        changed = true;
+    }
+    if (changed) zoneDirty[uint8_t(zone)] = true;
+}
+
+void LedComp_statusSet(LedZoneId zone, uint16_t offset, uint32_t argb) {
+    LedComp_statusFill(zone, offset, 1, argb);
+}
+
+// Advances BASE/ALERT and re-renders them if their effect state moved
+static void updateEffectLayer(LedLayer &l, LedLayerId id, const LedZone &zone, uint8_t zoneIdx, uint32_t dtMs) {
+    if (l.remainingMs) {
+        if (dtMs >= l.remainingMs) {   // alert over
+            l.spec.fx = LedLayerFx::OFF;
+            l.remainingMs = 0;
+            l.stale = true;
+        } else {
+            l.remainingMs -= dtMs;
+        }
+    }
+    if (l.spec.fx == LedLayerFx::OFF && !l.stale) return;
+
+    LedPhase_advance(l.phase, dtMs);
+    uint16_t key = effectKey(l, zone);
+    if (!l.stale && key == l.renderedKey) return;
+
+    renderEffect(layerPixels[uint8_t(id)], l, zone, key);
+    l.renderedKey = key;
+    l.stale = false;
+    zoneDirty[zoneIdx] = true;
+}
+
+// Blends the layers of one zone bottom to top over black
+static void compositeZone(uint8_t z, const LedZone &zone, LedFrame &frame) {
+    const LedLayer *stack = layers[z];
+    for (uint16_t i = zone.start; i < zone.end(); i++) {
+        uint32_t rgb = 0;
+        for (uint8_t l = 0; l < LED_LAYER_COUNT; l++) {
+            if (stack[l].alpha) rgb = LedFx_blend(rgb, layerPixels[l][i], stack[l].alpha);
+        }
+        frame.set(i, rgb);
+    }
+}
+
+bool LedComp_render(uint32_t dtMs, LedFrame &frame) {
+    const LedZoneMap &zones = LedZones_get();
+    bool wrote = false;
+    for (uint8_t z = 0; z < LED_ZONE_COUNT; z++) {
+        const LedZone &zone = zones.zones[z];
+        if (zone.count == 0) {
+            zoneDirty[z] = false;
+            continue;
+        }
+        updateEffectLayer(layers[z][uint8_t(LedLayerId::BASE)], LedLayerId::BASE, zone, z, dtMs);
+        updateEffectLayer(layers[z][uint8_t(LedLayerId::ALERT)], LedLayerId::ALERT, zone, z, dtMs);
+        if (!zoneDirty[z]) continue;
+        compositeZone(z, zone, frame);
+        zoneDirty[z] = false;
+        wrote = true;
+    }
+    return wrote;
+}
+
+static void printEffect(Print &p, const LedLayer &l) {
+    p.print(fxNames[uint8_t(l.spec.fx)]);
+    if (l.spec.fx == LedLayerFx::OFF) return;
+    char buf[24];
+    snprintf(buf, sizeof(buf), " %06lX", (unsigned long)l.spec.color);
+    p.print(buf);
+    if (l.spec.fx != LedLayerFx::SOLID) {
+        p.print(' ');
+        p.print(l.spec.periodMs);
+        p.print(F("ms"));
+    }
+    if (l.remainingMs) {
+        p.print(F(" for "));
+        p.print(l.remainingMs);
+        p.print(F("ms"));
+    }
+}
+
+void LedComp_print(Print &p) {
+    for (uint8_t z = 0; z < LED_ZONE_COUNT; z++) {
+        const LedLayer *stack = layers[z];
+        p.print(F("[LED] "));
+        p.print(zoneNames[z]);
+        p.print(F(" base="));
+        printEffect(p, stack[uint8_t(LedLayerId::BASE)]);
+        p.print(F(" a="));
+        p.print(stack[uint8_t(LedLayerId::BASE)].alpha);
+        p.print(F(" status a="));
+        p.print(stack[uint8_t(LedLayerId::STATUS)].alpha);
+        p.print(F(" alert="));
+        printEffect(p, stack[uint8_t(LedLayerId::ALERT)]);
+        p.print(F(" a="));
+        p.println(stack[uint8_t(LedLayerId::ALERT)].alpha);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include "LedZones.h"
+#include "LedFrame.h"
+
+// Layered LED compositor for AUTO mode.
+// Every zone of the active zone map has three layers, blended bottom to top
+// in fixed point (LedFx_blend) over black:
+//
+//   BASE    app-chosen effect (e.g. a team colour), off by default
+//   STATUS  live bot/weapon status, written by Leds through statusFill/Set
+//   ALERT   transient app effect that expires after its duration
+//
+// Layer pixels are 0xAARRGGBB, so a layer can leave pixels transparent (a
+// BLINK alert in its off phase, the drive status between wipe dots) and
+// each layer has an opacity on top. A layer is re-rendered only when its
+// spec or its effect state (blink phase, pulse level, wipe position)
+// changes; a zone is re-composited only when one of its layers changed.
+// The layer settings persist while a whole-strip override (L0..L4) is shown.
+// Comms side only.
+
+enum class LedLayerId : uint8_t {
+    BASE,
+    STATUS,
+    ALERT,
+    COUNT
+};
+
+constexpr uint8_t LED_LAYER_COUNT = uint8_t(LedLayerId::COUNT);
+
+// Same numbering as the whole-strip commands L0..L4
+enum class LedLayerFx : uint8_t {
+    OFF,     // transparent
+    SOLID,
+    BLINK,   // colour / transparent, 50 % duty
+    PULSE,   // colour with a triangle-wave alpha
+    WIPE     // one pixel moving through the zone, periodMs per pixel
+};
+
+struct LedLayerSpec {
+    LedLayerFx fx;
+    uint32_t color;        // 0xRRGGBB
+    uint16_t periodMs;     // BLINK/PULSE: cycle, WIPE: step time
+};
+
+constexpr uint32_t LED_ARGB_OPAQUE = 0xFF000000;
+
+void LedComp_init();
+void LedComp_reset();                       // all layers back to defaults (STATUS shown, rest off)
+void LedComp_redraw();                      // entered AUTO or new zone map: rebuild every layer and zone
+
+// BASE/ALERT effects; durationMs > 0 ends an ALERT after that time
+void LedComp_setEffect(LedZoneId zone, LedLayerId layer, const LedLayerSpec &spec, uint32_t durationMs = 0);
+void LedComp_setAlpha(LedZoneId zone, LedLayerId layer, uint8_t alpha);
+
+// STATUS layer pixels, offsets relative to the zone start (clipped to the zone)
+void LedComp_statusFill(LedZoneId zone, uint16_t offset, uint16_t n, uint32_t argb);
+void LedComp_statusSet(LedZoneId zone, uint16_t offset, uint32_t argb);
+
+// Advances the effect layers by dtMs, re-renders what changed and writes
+// re-composited zones into frame; true if any zone was written
+bool LedComp_render(uint32_t dtMs, LedFrame &frame);
+
+void LedComp_print(Print &p);
@@ -0,0 +1,7 @@
+#include "LedEffects.h"
+
+void LedPhase_start(LedPhase &p, uint32_t cycleMs) {
+    if (cycleMs < 2) cycleMs = 2;     // 2^32 / 1 does not fit the rate
+    p.acc = 0;
+    p.ratePerMs = uint32_t(((1ULL << 32) + cycleMs / 2) / cycleMs);
+}
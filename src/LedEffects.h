@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fixed-point building blocks for the LED effects.
+//
+// LedPhase: 32-bit accumulator, one wrap = one effect cycle. advance() adds
+// dtMs * ratePerMs, so tick jitter adds no error. The rate is 2^32 / cycleMs
+// rounded to the nearest LSB, so the phase drifts by at most half an LSB
+// (2^-33 cycle) per ms: a cycle ends at most cycleMs^2 / 2^33 ms early or
+// late, e.g. under 0.012 ms for a 10 s cycle. The effects read the top 16
+// bits as 8.8 fixed point: integer part = position in a 256-step cycle,
+// fraction = sub-step.
+
+struct LedPhase {
+    uint32_t acc;
+    uint32_t ratePerMs;
+};
+
+void LedPhase_start(LedPhase &p, uint32_t cycleMs);   // phase 0, cycleMs >= 2
+
+inline void LedPhase_advance(LedPhase &p, uint32_t dtMs) {
+    p.acc += dtMs * p.ratePerMs;
+}
+
+inline uint16_t LedPhase_get88(const LedPhase &p) {
+    return uint16_t(p.acc >> 16);
+}
+
+// Triangle wave over one cycle: 0 -> 255 -> 0
+inline uint8_t LedFx_triangle(uint16_t phase88) {
+    return uint8_t(phase88 < 0x8000 ? phase88 >> 7 : (0xFFFF - phase88) >> 7);
+}
+
+// Per-channel scale by level/256 (+1 so that 255 keeps the colour)
+inline uint32_t LedFx_scale(uint32_t rgb, uint8_t level) {
+    uint32_t f = uint32_t(level) + 1;
+    return ((((rgb >> 16) & 0xFF) * f >> 8) << 16) |
+           ((((rgb >> 8) & 0xFF) * f >> 8) << 8) |
+           ((rgb & 0xFF) * f >> 8);
+}
+
+// Threshold for a duty cycle in percent, compared against the 8.8 phase
+inline uint16_t LedFx_dutyPhase88(uint8_t dutyPercent) {
+    return uint16_t(uint32_t(dutyPercent > 100 ? 100 : dutyPercent) * 0xFFFFU / 100U);
+}
+
+// x/255 rounded, exact for x <= 255 * 255 (no division)
+inline uint32_t LedFx_div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Layer pixels are 0xAARRGGBB; AA = 0 is transparent, 0xFF opaque.
+// Blends argb over dst (0xRRGGBB) with the pixel alpha scaled by the layer
+// opacity. Opaque pixels replace dst exactly, transparent ones keep it.
+inline uint32_t LedFx_blend(uint32_t dst, uint32_t argb, uint8_t layerAlpha) {
+    uint32_t a = LedFx_div255((argb >> 24) * layerAlpha);
+    if (a == 0) return dst;
+    uint32_t inv = 255 - a;
+    return (LedFx_div255(((dst >> 16) & 0xFF) * inv + ((argb >> 16) & 0xFF) * a) << 16) |
+           (LedFx_div255(((dst >> 8) & 0xFF) * inv + ((argb >> 8) & 0xFF) * a) << 8) |
+           LedFx_div255((dst & 0xFF) * inv + (argb & 0xFF) * a);
+}
+
+// Position 0..count-1 of a pixel that crosses count pixels per cycle
+inline uint16_t LedFx_position(uint16_t phase88, uint16_t count) {
+    return uint16_t((uint32_t(phase88) * count) >> 16);
+}
@@ -0,0 +1,111 @@
+#include "LedFrame.h"
+#include "LedGamma.h"
+#include "Hal.h"
+
+LedFrame::LedFrame(uint32_t *pixels, uint16_t capacity)
+    : pixels_(pixels), capacity_(capacity), count_(capacity), spanCount_(0), uniform_(true), uniformColor_(0) {
+    for (uint16_t i = 0; i < count_; i++) pixels_[i] = 0;
+}
+
+void LedFrame::setCount(uint16_t count) {
+    if (count > capacity_) count = capacity_;
+    if (count < count_) {
+        fill(count, uint16_t(count_ - count), 0);
+    } else if (count > count_ && uniformColor_ != 0) {
+        uniform_ = false;   // the pixels coming back are dark
+    }
+    count_ = count;
+}
+
+void LedFrame::set(uint16_t idx, uint32_t rgb) {
+    if (idx >= count_ || pixels_[idx] == rgb) return;
+    pixels_[idx] = rgb;
+    uniform_ = false;
+    markDirty(idx, uint16_t(idx + 1));
+}
+
+void LedFrame::fill(uint16_t start, uint16_t n, uint32_t rgb) {
+    if (start >= count_) return;
+    uint16_t end = (n > count_ - start) ? count_ : uint16_t(start + n);
+
+    if (start == 0 && end == count_) {
+        if (uniform_ && uniformColor_ == rgb) return;
+        for (uint16_t i = 0; i < count_; i++) pixels_[i] = rgb;
+        uniform_ = true;
+        uniformColor_ = rgb;
+        // The new span covers every older one except pixels setCount() dropped
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < spanCount_; i++) {
+            if (spans_[i].hi > count_) spans_[kept++] = spans_[i];
+        }
+        spanCount_ = kept;
+        markDirty(0, count_);
+        return;
+    }
+
+    // Only the changed part of the range becomes dirty
+    uint16_t lo = end;
+    uint16_t hi = start;
+    for (uint16_t i = start; i < end; i++) {
+        if (pixels_[i] == rgb) continue;
+        pixels_[i] = rgb;
+        if (i < lo) lo = i;
+        hi = uint16_t(i + 1);
+    }
+    if (lo < hi) {
+        uniform_ = false;
+        markDirty(lo, hi);
+    }
+}
+
+void LedFrame::invalidate() {
+    spanCount_ = 0;
+    if (count_) markDirty(0, count_);
+}
+
+void LedFrame::markDirty(uint16_t lo, uint16_t hi) {
+    // Grow an overlapping or adjacent span
+    for (uint8_t i = 0; i < spanCount_; i++) {
+        Span &s = spans_[i];
+        if (lo > s.hi || hi < s.lo) continue;
+        if (lo < s.lo) s.lo = lo;
+        if (hi > s.hi) s.hi = hi;
+        return;
+    }
+    if (spanCount_ < LED_FRAME_SPANS) {
+        spans_[spanCount_++] = {lo, hi};
+        return;
+    }
+
+    // Full: merge into the span with the smallest gap
+    uint8_t best = 0;
+    uint32_t bestGap = UINT32_MAX;
+    for (uint8_t i = 0; i < spanCount_; i++) {
+        uint32_t gap = (lo > spans_[i].hi) ? lo - spans_[i].hi : spans_[i].lo - hi;
+        if (gap < bestGap) {
+            bestGap = gap;
+            best = i;
+        }
+    }
+    if (lo < spans_[best].lo) spans_[best].lo = lo;
+    if (hi > spans_[best].hi) spans_[best].hi = hi;
+}
+
+bool LedFrame::flush() {
+    bool changed = false;
+    if (uniform_) {
+        uint32_t encoded = LedGamma_encode(uniformColor_);
+        for (uint8_t i = 0; i < spanCount_; i++) {
+            for (uint16_t p = spans_[i].lo; p < spans_[i].hi; p++) changed |= Hal_pixelsSet(p, encoded);
+        }
+        spanCount_ = 0;
+        return changed;
+    }
+    for (uint8_t i = 0; i < spanCount_; i++) {
+        for (uint16_t p = spans_[i].lo; p < spans_[i].hi; p++) {
+            changed |= Hal_pixelsSet(p, LedGamma_encode(pixels_[p]));
+        }
+    }
+    spanCount_ = 0;
+    return changed;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Pixel frame with dirty-span tracking for the LED engine.
+// Writes compare against the current frame and only mark pixels that really
+// change; changed pixels collect in up to LED_FRAME_SPANS dirty spans (one per
+// zone in practice, a further span merges into the nearest). flush() hands
+// just those spans to the HAL, gamma/brightness-encoded by LedGamma, and
+// reports whether the encoded strip frame changed, so show() is only needed
+// when it did.
+//
+// Whole-strip fills (pulse, blink, solid) take a fast path: the frame knows
+// when every pixel has one colour, so such a fill either returns at once or
+// stores the new colour without comparing and marks a single span, and
+// flush() encodes that colour once.
+//
+// The caller owns the pixel buffer (capacity entries, 0xRRGGBB). count() is
+// the strip length in use and may be set below the capacity at runtime.
+
+constexpr uint8_t LED_FRAME_SPANS = 4;
+
+class LedFrame {
+public:
+    LedFrame(uint32_t *pixels, uint16_t capacity);
+
+    uint16_t count() const { return count_; }
+    uint32_t get(uint16_t idx) const { return idx < count_ ? pixels_[idx] : 0; }
+
+    void set(uint16_t idx, uint32_t rgb);
+    void fill(uint16_t start, uint16_t n, uint32_t rgb);    // clipped to the strip
+    void clear() { fill(0, count_, 0); }
+
+    // Changes the strip length (clipped to the capacity); pixels that drop
+    // out are blanked so the next flush turns them off
+    void setCount(uint16_t count);
+
+    bool dirty() const { return spanCount_ != 0; }
+
+    // Writes the dirty spans to Hal_pixelsSet; true if the HAL frame changed
+    bool flush();
+
+    // Marks everything dirty (e.g. after Hal_pixelsBegin or a brightness change)
+    void invalidate();
+
+private:
+    struct Span {
+        uint16_t lo;
+        uint16_t hi;    // exclusive
+    };
+
+    void markDirty(uint16_t lo, uint16_t hi);
+
+    uint32_t *pixels_;
+    uint16_t capacity_;
+    uint16_t count_;
+    Span spans_[LED_FRAME_SPANS];
+    uint8_t spanCount_;
+    bool uniform_;              // every pixel is uniformColor_
+    uint32_t uniformColor_;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Gamma + brightness lookup for the pixel output.
+// Colours in the LED engine are perceptual levels (0xRRGGBB); LedFrame runs
+// every pixel through LedGamma_encode() on its way to the HAL, which sends
+// the bytes unchanged. The table is rebuilt by setBrightness (integer math
+// only, so host and target produce the same bytes):
+//   out = round(gamma16[v] * brightness / 65535), gamma16 = 65535 * (v/255)^2.2
+
+void LedGamma_setBrightness(uint8_t brightness);
+uint8_t LedGamma_getBrightness();
+
+uint16_t LedGamma_curve(uint8_t v);         // gamma16[v], for checks
+uint32_t LedGamma_encode(uint32_t rgb);     // per channel through the table
@@ -0,0 +1,40 @@
+#include "LedZones.h"
+
+static LedZoneMap activeMap = LED_DEFAULT_ZONES;
+
+void LedZones_init() {
+    activeMap = LED_DEFAULT_ZONES;
+}
+
+bool LedZones_load(const LedZoneMap &map) {
+    if (!ledZoneMapValid(map)) return false;
+    activeMap = map;
+    return true;
+}
+
+const LedZoneMap &LedZones_get() {
+    return activeMap;
+}
+
+void LedZones_print(Print &p) {
+    static const char *const names[LED_ZONE_COUNT] = {"left", "weapon", "right"};
+    p.print(F("[LED] zones"));
+    for (uint8_t i = 0; i < LED_ZONE_COUNT; i++) {
+        const LedZone &z = activeMap.zones[i];
+        p.print(' ');
+        p.print(names[i]);
+        p.print('=');
+        if (z.count == 0) {
+            p.print('-');
+            continue;
+        }
+        p.print(z.start);
+        p.print('-');
+        p.print(z.end() - 1);
+    }
+    p.print(F(" of "));
+    p.print(activeMap.pixels);
+    p.print(F(" (max "));
+    p.print(LED_COUNT);
+    p.println(')');
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config.h"
+
+// LED zone map for the AUTO layout: the strip length and one contiguous span
+// per zone. LED_COUNT is the pixel buffer capacity; a map may describe any
+// shorter strip. A map is valid when its length fits the buffer, every zone
+// lies inside the strip and no two zones overlap (empty zones are allowed and
+// skipped). The default map from Config.h is checked at build time; LM= loads
+// another one at runtime after the same check, so renderers can iterate the
+// spans without bounds checks.
+
+enum class LedZoneId : uint8_t {
+    DRIVE_LEFT,
+    WEAPON,
+    DRIVE_RIGHT,
+    COUNT
+};
+
+constexpr uint8_t LED_ZONE_COUNT = uint8_t(LedZoneId::COUNT);
+
+struct LedZone {
+    uint16_t start;
+    uint16_t count;
+
+    constexpr uint16_t end() const { return uint16_t(start + count); }
+};
+
+struct LedZoneMap {
+    LedZone zones[LED_ZONE_COUNT];
+    uint16_t pixels;    // strip length, 1..LED_COUNT
+
+    const LedZone &operator[](LedZoneId id) const { return zones[uint8_t(id)]; }
+};
+
+// --- constexpr validation (C++11: one return statement per function) ---
+
+constexpr bool ledZoneInStrip(const LedZone &z, uint16_t pixels) {
+    return z.count == 0 || (z.start < pixels && z.count <= pixels - z.start);
+}
+
+constexpr bool ledZonesOverlap(const LedZone &a, const LedZone &b) {
+    return a.count != 0 && b.count != 0 && a.start < b.end() && b.start < a.end();
+}
+
+// zone i against zones j..COUNT-1
+constexpr bool ledZoneClearFrom(const LedZoneMap &m, uint8_t i, uint8_t j) {
+    return j >= LED_ZONE_COUNT ||
+           (!ledZonesOverlap(m.zones[i], m.zones[j]) && ledZoneClearFrom(m, i, uint8_t(j + 1)));
+}
+
+constexpr bool ledZoneMapValidFrom(const LedZoneMap &m, uint16_t pixels, uint8_t i) {
+    return i >= LED_ZONE_COUNT ||
+           (ledZoneInStrip(m.zones[i], pixels) && ledZoneClearFrom(m, i, uint8_t(i + 1)) &&
+            ledZoneMapValidFrom(m, pixels, uint8_t(i + 1)));
+}
+
+constexpr bool ledZoneMapValid(const LedZoneMap &m) {
+    return m.pixels > 0 && m.pixels <= LED_COUNT && ledZoneMapValidFrom(m, m.pixels, 0);
+}
+
+constexpr LedZoneMap LED_DEFAULT_ZONES = {{
+    {LED_DRIVE_LEFT_START, LED_DRIVE_LEFT_COUNT},
+    {LED_WEAPON_START, LED_WEAPON_COUNT},
+    {LED_DRIVE_RIGHT_START, LED_DRIVE_RIGHT_COUNT},
+}, LED_COUNT};
+
+static_assert(ledZoneMapValid(LED_DEFAULT_ZONES),
+              "LED zone layout in Config.h overlaps or exceeds LED_COUNT");
+
+// --- active map (comms side) ---
+
+void LedZones_init();                       // default map
+bool LedZones_load(const LedZoneMap &map);  // false (map unchanged) if invalid
+const LedZoneMap &LedZones_get();
+void LedZones_print(Print &p);
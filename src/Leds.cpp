@@ -4,13 +4,16 @@
 #include "Drive.h"
 #include "Weapon.h"
 #include "Diagnostics.h"
-#include <Adafruit_NeoPixel.h>
+#include "LedFrame.h"
+#include "LedZones.h"
+#include "LedGamma.h"
+#include "LedEffects.h"
+#include "LedCompositor.h"
+#include "Hal.h"
 
 // Internal state structure
 static struct
 {
-    Adafruit_NeoPixel strip;
-
     LedMode currentMode;
     bool overrideActive; // true if user command overrides AUTO mode
 
@@ -18,31 +21,38 @@ static struct
     uint16_t periodMs; // Effect period for BLINK/PULSE/WIPE
     uint8_t dutyCycle; // Duty cycle for BLINK (0..100 %)
 
-    uint32_t phaseStartMs; // When current phase/cycle began
-    uint8_t wipePosition;  // Current position for WIPE effect
+    LedPhase phase;           // BLINK/PULSE: one cycle per period, WIPE: one pass over the strip
+    uint16_t blinkOnPhase88;  // BLINK is on while the phase is below this
+    uint16_t wipePosition;    // Current position for WIPE effect
 
     BotState lastBotState; // Cached state for AUTO mode
     WeaponState lastWeaponState;
 
-    bool dirty;               // true if pixels changed, need show()
+    bool autoRedraw;          // AUTO must repaint every zone (entered AUTO, new zone map)
+    bool showPending;         // frame rendered, strip was still busy sending the last one
     unsigned long lastTickMs; // Last LED update tick
 
 } s_led = {
-    Adafruit_NeoPixel(LED_COUNT, PIN_LED_DATA, NEO_GRB + NEO_KHZ800),
     LedMode::AUTO,
     false,
     0x202020, // Default dim white
     500,
     50,
+    {0, 0},
     0,
     0,
     BotState::IDLE,
     WeaponState::DISARMED,
+    true,
     false,
     0};
 
+// Frame the effects render into; only changed spans reach the HAL
+static uint32_t s_pixels[LED_COUNT];
+static LedFrame s_frame(s_pixels, LED_COUNT);
+
 // Helper: parse 2-digit hex string to uint8_t
-static bool parseHex2(const String &s, int offset, uint8_t &out)
+static bool parseHex2(const LineView &s, int offset, uint8_t &out)
 {
     if (offset + 2 > (int)s.length())
         return false;
@@ -55,57 +65,160 @@ static bool parseHex2(const String &s, int offset, uint8_t &out)
     return true;
 }
 
-// Helper: set all pixels to same color
-static void setAllPixels(uint32_t color)
+// Helper: parse "LM=<ls>,<lc>,<ws>,<wc>,<rs>,<rc>[,<pixels>]" (decimal,
+// strip length defaults to LED_COUNT)
+static bool parseZoneMap(const LineView &s, LedZoneMap &out)
 {
-    for (int i = 0; i < LED_COUNT; i++)
+    if (!s.startsWith("LM="))
+        return false;
+    const uint8_t zoneValues = LED_ZONE_COUNT * 2;
+    uint16_t values[zoneValues + 1];
+    values[zoneValues] = LED_COUNT;
+    size_t pos = 3;
+    for (uint8_t i = 0; i <= zoneValues; i++)
     {
-        s_led.strip.setPixelColor(i, color);
+        size_t start = pos;
+        uint32_t v = 0;
+        while (pos < s.length() && isDigit(s[pos]) && v <= 0xFFFF)
+        {
+            v = v * 10 + uint32_t(s[pos] - '0');
+            pos++;
+        }
+        if (pos == start || v > 0xFFFF)
+            return false;
+        values[i] = uint16_t(v);
+        if (pos == s.length() && i + 1 >= zoneValues)
+            break;
+        if (s[pos] != ',' || i == zoneValues)
+            return false;
+        pos++;
     }
-    s_led.dirty = true;
+    for (uint8_t z = 0; z < LED_ZONE_COUNT; z++)
+    {
+        out.zones[z].start = values[2 * z];
+        out.zones[z].count = values[2 * z + 1];
+    }
+    out.pixels = values[zoneValues];
+    return true;
 }
 
-// Helper: clear all pixels
-static void clearAllPixels()
+// Helper: parse an LZ effect "<m>[RRGGBB[PP]]" (m and PP as in L0..L4) at
+// offset; returns its length, 0 if invalid
+static size_t parseLayerEffect(const LineView &s, size_t offset, LedLayerSpec &out)
 {
-    s_led.strip.clear();
-    s_led.dirty = true;
+    if (offset >= s.length())
+        return 0;
+    char m = s[offset];
+    if (m == '0')
+    {
+        out = {LedLayerFx::OFF, 0, 0};
+        return 1;
+    }
+    uint8_t r, g, b;
+    if (m < '1' || m > '4' || !parseHex2(s, int(offset + 1), r) || !parseHex2(s, int(offset + 3), g) ||
+        !parseHex2(s, int(offset + 5), b))
+        return 0;
+    out.fx = LedLayerFx(m - '0');
+    out.color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    out.periodMs = 0;
+    if (m == '1')
+        return 7;
+
+    uint8_t period;
+    if (!parseHex2(s, int(offset + 7), period) || period < 1 || period > 99)
+        return 0;
+    out.periodMs = (m == '4') ? period * 10 : period * 100; // WIPE: step time
+    return 9;
 }
 
-// Helper: set one pixel
-static void setOnePixel(uint16_t idx, uint32_t color)
+// Helper: LZ<z><l>=... / LZ<z><l>@AA; z = L/W/R or * (all zones), l = B/S/A
+static bool handleLayerCommand(const LineView &line)
 {
-    if (idx < LED_COUNT)
+    if (line.length() < 6)
+        return false;
+
+    uint8_t first = 0, last = LED_ZONE_COUNT - 1;
+    switch (line[2])
     {
-        s_led.strip.setPixelColor(idx, color);
-        s_led.dirty = true;
+    case 'L': first = last = uint8_t(LedZoneId::DRIVE_LEFT); break;
+    case 'W': first = last = uint8_t(LedZoneId::WEAPON); break;
+    case 'R': first = last = uint8_t(LedZoneId::DRIVE_RIGHT); break;
+    case '*': break;
+    default: return false;
     }
-}
 
-// Helper: set pixel range to same color
-static void setRange(uint16_t start, uint16_t count, uint32_t color)
-{
-    for (uint16_t i = 0; i < count; i++)
+    LedLayerId layer;
+    switch (line[3])
     {
-        if (start + i < LED_COUNT)
-        {
-            s_led.strip.setPixelColor(start + i, color);
-        }
+    case 'B': layer = LedLayerId::BASE; break;
+    case 'S': layer = LedLayerId::STATUS; break;
+    case 'A': layer = LedLayerId::ALERT; break;
+    default: return false;
     }
-    s_led.dirty = true;
-}
 
-// Helper: clear pixel range
-static void clearRange(uint16_t start, uint16_t count)
-{
-    for (uint16_t i = 0; i < count; i++)
+    // Layer opacity
+    if (line[4] == '@')
     {
-        if (start + i < LED_COUNT)
-        {
-            s_led.strip.setPixelColor(start + i, 0);
-        }
+        uint8_t alpha;
+        if (line.length() != 7 || !parseHex2(line, 5, alpha))
+            return false;
+        for (uint8_t z = first; z <= last; z++)
+            LedComp_setAlpha(LedZoneId(z), layer, alpha);
+        return true;
+    }
+    if (line[4] != '=')
+        return false;
+
+    // STATUS always shows the live bot state: =0 hides it, =1 shows it
+    if (layer == LedLayerId::STATUS)
+    {
+        if (line.length() != 6 || (line[5] != '0' && line[5] != '1'))
+            return false;
+        for (uint8_t z = first; z <= last; z++)
+            LedComp_setAlpha(LedZoneId(z), layer, line[5] == '1' ? 0xFF : 0);
+        return true;
+    }
+
+    LedLayerSpec spec;
+    size_t end = parseLayerEffect(line, 5, spec);
+    if (end == 0)
+        return false;
+    end += 5;
+
+    // ALERT effects end after DD = 01..99 (decimal) -> 100..9900 ms
+    uint32_t durationMs = 0;
+    if (layer == LedLayerId::ALERT && spec.fx != LedLayerFx::OFF)
+    {
+        char d1 = line[end], d2 = line[end + 1];
+        if (!isDigit(d1) || !isDigit(d2) || (d1 == '0' && d2 == '0'))
+            return false;
+        durationMs = uint32_t((d1 - '0') * 10 + (d2 - '0')) * 100;
+        end += 2;
     }
-    s_led.dirty = true;
+    if (line.length() != end)
+        return false;
+
+    for (uint8_t z = first; z <= last; z++)
+        LedComp_setEffect(LedZoneId(z), layer, spec, durationMs);
+    return true;
+}
+
+// Helper: set all pixels to same color (LedFrame returns at once if the strip already is)
+static void setAllPixels(uint32_t color)
+{
+    s_frame.fill(0, s_frame.count(), color);
+}
+
+// Helper: clear all pixels
+static void clearAllPixels()
+{
+    setAllPixels(0);
+}
+
+// Helper: set one pixel
+static void setOnePixel(uint16_t idx, uint32_t color)
+{
+    s_frame.set(idx, color);
 }
 
 // Helper: apply SOLID effect
@@ -114,20 +227,23 @@ static void applySolid()
     setAllPixels(s_led.color);
 }
 
-// Helper: apply BLINK effect (non-blocking, time-based)
-static void applyBlink(unsigned long nowMs)
+// Restart the effect phase after a mode/period change
+static void restartEffect()
 {
-    if (s_led.periodMs == 0)
+    uint32_t cycleMs = s_led.periodMs;
+    if (s_led.currentMode == LedMode::WIPE)
     {
-        clearAllPixels();
-        return;
+        cycleMs *= s_frame.count(); // periodMs is the step time per pixel
     }
+    LedPhase_start(s_led.phase, cycleMs);
+    s_led.blinkOnPhase88 = LedFx_dutyPhase88(s_led.dutyCycle);
+    s_led.wipePosition = UINT16_MAX; // draw on the next tick
+}
 
-    unsigned long elapsed = nowMs - s_led.phaseStartMs;
-    unsigned long cycle = elapsed % s_led.periodMs;
-    uint32_t onTime = (uint32_t(s_led.periodMs) * s_led.dutyCycle) / 100;
-
-    if (cycle < onTime)
+// Helper: apply BLINK effect (non-blocking, phase-based)
+static void applyBlink()
+{
+    if (LedPhase_get88(s_led.phase) < s_led.blinkOnPhase88)
     {
         setAllPixels(s_led.color);
     }
@@ -137,74 +253,31 @@ static void applyBlink(unsigned long nowMs)
     }
 }
 
-// Helper: apply PULSE effect (breathing, triangle wave)
-static void applyPulse(unsigned long nowMs)
+// Helper: apply PULSE effect (breathing, triangle wave; gamma makes the fade even)
+static void applyPulse()
 {
-    if (s_led.periodMs == 0)
-    {
-        clearAllPixels();
-        return;
-    }
-
-    unsigned long elapsed = nowMs - s_led.phaseStartMs;
-    unsigned long cycle = elapsed % s_led.periodMs;
-
-    const uint32_t P = s_led.periodMs;
-    const uint32_t half = P / 2;
-
-    // Triangle wave: 0 -> peak -> 0
-    uint8_t brightness;
-    if (cycle < half)
-    {
-        // Rising
-        brightness = uint8_t((uint32_t(cycle) * 510U) / P);
-    }
-    else
-    {
-        // Falling
-        brightness = uint8_t(255U - (uint32_t(cycle - half) * 510U) / P);
-    }
-
-    // Extract RGB components
-    uint8_t r = (s_led.color >> 16) & 0xFF;
-    uint8_t g = (s_led.color >> 8) & 0xFF;
-    uint8_t b = s_led.color & 0xFF;
-
-    // Scale by brightness
-    r = (r * brightness) / 255;
-    g = (g * brightness) / 255;
-    b = (b * brightness) / 255;
-
-    uint32_t scaledColor = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-    setAllPixels(scaledColor);
+    uint8_t level = LedFx_triangle(LedPhase_get88(s_led.phase));
+    setAllPixels(level ? LedFx_scale(s_led.color, level) : 0);
 }
 
 // Helper: apply WIPE effect (single moving pixel)
-static void applyWipe(unsigned long nowMs)
+static void applyWipe()
 {
-    if (s_led.periodMs == 0 || LED_COUNT == 0)
-    {
-        clearAllPixels();
-        return;
-    }
-
-    unsigned long elapsed = nowMs - s_led.phaseStartMs;
-
-    // periodMs is used as step interval (ms per pixel move)
-    uint8_t newPos = (elapsed / s_led.periodMs) % LED_COUNT;
+    uint16_t newPos = LedFx_position(LedPhase_get88(s_led.phase), s_frame.count());
 
     if (newPos != s_led.wipePosition)
     {
         clearAllPixels();
-        s_led.strip.setPixelColor(newPos, s_led.color);
+        setOnePixel(newPos, s_led.color);
         s_led.wipePosition = newPos;
-        s_led.dirty = true;
     }
 }
 
 // Apply current mode's effect
-static void applyEffect(unsigned long nowMs)
+static void applyEffect(uint32_t dtMs)
 {
+    LedPhase_advance(s_led.phase, dtMs);
+
     switch (s_led.currentMode)
     {
     case LedMode::OFF:
@@ -216,15 +289,15 @@ static void applyEffect(unsigned long nowMs)
         break;
 
     case LedMode::BLINK:
-        applyBlink(nowMs);
+        applyBlink();
         break;
 
     case LedMode::PULSE:
-        applyPulse(nowMs);
+        applyPulse();
         break;
 
     case LedMode::WIPE:
-        applyWipe(nowMs);
+        applyWipe();
         break;
 
     case LedMode::AUTO:
@@ -233,42 +306,90 @@ static void applyEffect(unsigned long nowMs)
     }
 }
 
-// Composite rendering for AUTO mode: 3 zones (drive left, weapon center, drive right)
-static void renderAutoComposite(unsigned long nowMs)
+// Drive zone status layer in AUTO: moving pixel while driving (rest
+// transparent, so a base colour shows through), dim white when idle
+static void renderDriveZone(LedZoneId id, LedPhase &phase, int &lastWipePos, BotState bot,
+                            bool botChanged, uint32_t dtMs)
+{
+    constexpr uint32_t C_BLUE = 0x0000FF;  // DRIVE
+    constexpr uint32_t C_WHITE = 0x404040; // IDLE (perceptual level, dim after gamma)
+    constexpr uint32_t stepMs = 60;
+
+    const LedZone &zone = LedZones_get()[id];
+    if (zone.count == 0)
+    {
+        return;
+    }
+    if (botChanged)
+    {
+        LedPhase_start(phase, uint32_t(zone.count) * stepMs); // one pass over the zone
+    }
+    else
+    {
+        LedPhase_advance(phase, dtMs);
+    }
+    if (bot == BotState::DRIVE)
+    {
+        int pos = LedFx_position(LedPhase_get88(phase), zone.count);
+        if (pos != lastWipePos || botChanged)
+        {
+            LedComp_statusFill(id, 0, zone.count, 0);
+            LedComp_statusSet(id, uint16_t(pos), LED_ARGB_OPAQUE | C_BLUE);
+            lastWipePos = pos;
+        }
+    }
+    else if (botChanged)
+    { // IDLE
+        LedComp_statusFill(id, 0, zone.count, LED_ARGB_OPAQUE | C_WHITE);
+    }
+}
+
+// Composite rendering for AUTO mode: 3 zones from the active zone map
+// (drive left, weapon center, drive right). Bot/weapon state feeds the
+// STATUS layer; the compositor blends it with the BASE and ALERT layers.
+static void renderAutoComposite(uint32_t dtMs)
 {
     // Weapon colors based on state + throttle
     constexpr uint32_t C_GREEN = 0x00FF00;  // DISARMED (off)
     constexpr uint32_t C_YELLOW = 0xFFFF00; // ARMING (spin up)
     constexpr uint32_t C_RED = 0xFF0000;    // ARMED + full throttle (spinning)
-    constexpr uint32_t C_ORANGE = 0xFF8000; // ARMED + idle (spin down)
-
-    // Drive colors
-    constexpr uint32_t C_BLUE = 0x0000FF;  // DRIVE
-    constexpr uint32_t C_WHITE = 0x202020; // IDLE
+    constexpr uint32_t C_ORANGE = 0xFF8000; // ARMED + idle, partial throttle blends towards red
 
     BotState bot = Drive_getState();
     WeaponState wep = Weapon_getState();
     int weaponThrottle = Weapon_getTargetThrottleUs();
+    const LedZoneMap &zones = LedZones_get();
 
     static BotState lastBot = BotState::IDLE;
     static WeaponState lastWep = WeaponState::DISARMED;
     static int lastThrottle = ESC_OFF_US;
-    static unsigned long drvPhaseStart = 0;
+    static LedPhase drvPhaseLeft = {0, 0};
+    static LedPhase drvPhaseRight = {0, 0};
     static int lastWipePosLeft = -1;
     static int lastWipePosRight = -1;
 
     bool botChanged = (bot != lastBot);
     bool wepChanged = (wep != lastWep) || (weaponThrottle != lastThrottle);
 
+    // Repaint everything; pixels outside the zones stay dark
+    if (s_led.autoRedraw)
+    {
+        clearAllPixels();
+        LedComp_redraw();
+        botChanged = true;
+        wepChanged = true;
+        s_led.autoRedraw = false;
+    }
+
     if (botChanged)
     {
-        drvPhaseStart = nowMs;
         lastWipePosLeft = -1;
         lastWipePosRight = -1;
     }
 
-    // --- Weapon zone (center, 2 pixels) ---
-    if (LED_WEAPON_COUNT > 0)
+    // --- Weapon zone (center) ---
+    const LedZone &weaponZone = zones[LedZoneId::WEAPON];
+    if (weaponZone.count > 0 && wepChanged)
     {
         uint32_t weaponColor = C_GREEN; // Default: DISARMED
 
@@ -278,69 +399,21 @@ static void renderAutoComposite(unsigned long nowMs)
         }
         else if (wep == WeaponState::ARMED)
         {
-            // Check if full throttle or idle
-            const int throttleThreshold = (ESC_ARM_US + ESC_MAX_US) / 2;
-            if (weaponThrottle > throttleThreshold)
-            {
-                weaponColor = C_RED; // Full spin
-            }
-            else
-            {
-                weaponColor = C_ORANGE; // Idle/spin down
-            }
+            // Gradient over the setpoint: orange at idle -> red at full throttle
+            int t = constrain(weaponThrottle, ESC_ARM_US, ESC_MAX_US) - ESC_ARM_US;
+            uint32_t green = uint32_t(((C_ORANGE >> 8) & 0xFF) * (ESC_MAX_US - ESC_ARM_US - t) /
+                                      (ESC_MAX_US - ESC_ARM_US));
+            weaponColor = C_RED | (green << 8);
         }
 
-        if (wepChanged)
-        {
-            setRange(LED_WEAPON_START, LED_WEAPON_COUNT, weaponColor);
-        }
+        LedComp_statusFill(LedZoneId::WEAPON, 0, weaponZone.count, LED_ARGB_OPAQUE | weaponColor);
     }
 
-    // --- Left drive zone (0-6) ---
-    if (LED_DRIVE_LEFT_COUNT > 0)
-    {
-        if (bot == BotState::DRIVE)
-        {
-            const uint32_t stepMs = 60;
-            int pos = int(((nowMs - drvPhaseStart) / stepMs) % LED_DRIVE_LEFT_COUNT);
-            if (pos != lastWipePosLeft || botChanged)
-            {
-                clearRange(LED_DRIVE_LEFT_START, LED_DRIVE_LEFT_COUNT);
-                setOnePixel(LED_DRIVE_LEFT_START + pos, C_BLUE);
-                lastWipePosLeft = pos;
-            }
-        }
-        else
-        { // IDLE
-            if (botChanged)
-            {
-                setRange(LED_DRIVE_LEFT_START, LED_DRIVE_LEFT_COUNT, C_WHITE);
-            }
-        }
-    }
+    // --- Drive zones ---
+    renderDriveZone(LedZoneId::DRIVE_LEFT, drvPhaseLeft, lastWipePosLeft, bot, botChanged, dtMs);
+    renderDriveZone(LedZoneId::DRIVE_RIGHT, drvPhaseRight, lastWipePosRight, bot, botChanged, dtMs);
 
-    // --- Right drive zone (9-15) ---
-    if (LED_DRIVE_RIGHT_COUNT > 0)
-    {
-        if (bot == BotState::DRIVE)
-        {
-            const uint32_t stepMs = 60;
-            int pos = int(((nowMs - drvPhaseStart) / stepMs) % LED_DRIVE_RIGHT_COUNT);
-            if (pos != lastWipePosRight || botChanged)
-            {
-                clearRange(LED_DRIVE_RIGHT_START, LED_DRIVE_RIGHT_COUNT);
-                setOnePixel(LED_DRIVE_RIGHT_START + pos, C_BLUE);
-                lastWipePosRight = pos;
-            }
-        }
-        else
-        { // IDLE
-            if (botChanged)
-            {
-                setRange(LED_DRIVE_RIGHT_START, LED_DRIVE_RIGHT_COUNT, C_WHITE);
-            }
-        }
-    }
+    LedComp_render(dtMs, s_frame);
 
     lastBot = bot;
     lastWep = wep;
@@ -348,68 +421,86 @@ static void renderAutoComposite(unsigned long nowMs)
 }
 
 // Update AUTO mode based on bot/weapon state
-static void updateAutoMode(unsigned long nowMs)
+static void updateAutoMode(uint32_t dtMs)
+{
+    renderAutoComposite(dtMs);
+}
+
+// Hand the HAL frame to the strip; if the previous frame is still being
+// sent, keep it pending and retry on the next pass (never waits)
+static void flushFrame()
 {
-    renderAutoComposite(nowMs);
+    if (Hal_pixelsShow())
+    {
+        s_led.showPending = false;
+        return;
+    }
+    if (!s_led.showPending)
+    {
+        Diag_inc(DiagId::LED_SHOW_OVERRUN);
+        s_led.showPending = true;
+    }
 }
 
 void Leds_init()
 {
-    s_led.strip.begin();
-    s_led.strip.setBrightness(LED_BRIGHTNESS);
-    s_led.strip.clear();
-    s_led.strip.show();
+    LedZones_init();
+    LedComp_init();
+    LedGamma_setBrightness(LED_BRIGHTNESS);
+    Hal_pixelsBegin(LED_COUNT, PIN_LED_DATA);
+    Hal_pixelsClear();
+    Hal_pixelsShow();
+    s_frame.setCount(LedZones_get().pixels);
+    s_frame.clear();
+    s_frame.invalidate();
+    s_frame.flush();
 
     s_led.currentMode = LedMode::AUTO;
     s_led.overrideActive = false;
     s_led.color = 0x202020;
     s_led.periodMs = 500;
     s_led.dutyCycle = 50;
-    s_led.phaseStartMs = 0;
-    s_led.wipePosition = 0;
+    restartEffect();
     s_led.lastBotState = BotState::IDLE;
     s_led.lastWeaponState = WeaponState::DISARMED;
-    s_led.dirty = false;
+    s_led.autoRedraw = true;
+    s_led.showPending = false;
     s_led.lastTickMs = 0;
 }
 
 void Leds_update(unsigned long nowMs)
 {
+    if (s_led.showPending)
+    {
+        flushFrame();
+    }
+
     // Throttle updates to LED_TICK_MS interval (non-blocking)
-    if (nowMs - s_led.lastTickMs < LED_TICK_MS)
+    uint32_t dtMs = nowMs - s_led.lastTickMs;
+    if (dtMs < LED_TICK_MS)
     {
         return;
     }
     s_led.lastTickMs = nowMs;
 
-    s_led.dirty = false; // Reset dirty flag
-
     // Handle AUTO mode vs override modes
     if (!s_led.overrideActive)
     {
-        updateAutoMode(nowMs);
+        updateAutoMode(dtMs);
     }
     else
     {
-        applyEffect(nowMs);
+        applyEffect(dtMs);
     }
 
-    // Only call show() if pixels changed
-    if (s_led.dirty)
+    // Only send a frame if the encoded pixels changed
+    if (s_frame.flush())
     {
-        unsigned long startUs = micros();
-        s_led.strip.show();
-        unsigned long durationUs = micros() - startUs;
-
-        // Check if show() took too long
-        if (durationUs > LED_SHOW_BUDGET_US)
-        {
-            Diag_incLedShowOverrun();
-        }
+        flushFrame();
     }
 }
 
-bool Leds_handleCommand(const String &line)
+bool Leds_handleCommand(const LineView &line)
 {
     // Expected format:
     // L0              -> OFF
@@ -418,10 +509,12 @@ bool Leds_handleCommand(const String &line)
     // L3RRGGBBPP      -> PULSE (PP = period 01..99 -> 100..9900ms)
     // L4RRGGBBPP      -> WIPE (PP = stepMs/10)
     // LA              -> AUTO
+    // LM? / LM=...    -> zone map (AUTO layout)
+    // LZ? / LZ- / LZ<z><l>=... / LZ<z><l>@AA -> AUTO zone layers (see handleLayerCommand)
 
     if (line.length() < 2 || line[0] != 'L')
     {
-        Diag_incInvalidLedCommand();
+        Diag_inc(DiagId::INVALID_LED_COMMAND);
         return false;
     }
 
@@ -432,13 +525,56 @@ bool Leds_handleCommand(const String &line)
     {
         if (line.length() != 2)
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
         s_led.currentMode = LedMode::AUTO;
         s_led.overrideActive = false;
-        s_led.phaseStartMs = millis();
-        s_led.wipePosition = 0;
+        s_led.autoRedraw = true;
+        return true;
+    }
+
+    // Zone map: LM? | LM=<ls>,<lc>,<ws>,<wc>,<rs>,<rc>[,<pixels>] (start,count per zone, strip length)
+    if (cmd == 'M')
+    {
+        if (line == "LM?")
+        {
+            LedZones_print(Serial);
+            return true;
+        }
+        LedZoneMap map;
+        if (!parseZoneMap(line, map) || !LedZones_load(map))
+        {
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
+            return false;
+        }
+        if (map.pixels != s_frame.count())
+        {
+            s_frame.setCount(map.pixels);
+            restartEffect(); // WIPE runs over the new length
+        }
+        s_led.autoRedraw = true;
+        return true;
+    }
+
+    // Zone layers: LZ? | LZ- (defaults) | LZ<z><l>=<effect> | LZ<z><l>@AA (opacity)
+    if (cmd == 'Z')
+    {
+        if (line == "LZ?")
+        {
+            LedComp_print(Serial);
+            return true;
+        }
+        if (line == "LZ-")
+        {
+            LedComp_reset();
+            return true;
+        }
+        if (!handleLayerCommand(line))
+        {
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
+            return false;
+        }
         return true;
     }
 
@@ -447,21 +583,15 @@ bool Leds_handleCommand(const String &line)
     {
         if (line.length() != 2)
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
         s_led.currentMode = LedMode::OFF;
         s_led.overrideActive = true;
-        s_led.phaseStartMs = millis();
         clearAllPixels();
-
-        // Immediate show with budget measurement
-        unsigned long startUs = micros();
-        s_led.strip.show();
-        unsigned long durationUs = micros() - startUs;
-        if (durationUs > LED_SHOW_BUDGET_US)
+        if (s_frame.flush())
         {
-            Diag_incLedShowOverrun();
+            s_led.showPending = true; // sent by the next Leds_update pass, not from the parser
         }
 
         return true;
@@ -472,21 +602,20 @@ bool Leds_handleCommand(const String &line)
     {
         if (line.length() != 8)
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
 
         uint8_t r, g, b;
         if (!parseHex2(line, 2, r) || !parseHex2(line, 4, g) || !parseHex2(line, 6, b))
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
 
         s_led.currentMode = LedMode::SOLID;
         s_led.overrideActive = true;
         s_led.color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-        s_led.phaseStartMs = millis();
         return true;
     }
 
@@ -495,7 +624,7 @@ bool Leds_handleCommand(const String &line)
     {
         if (line.length() != 10)
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
 
@@ -503,20 +632,18 @@ bool Leds_handleCommand(const String &line)
         if (!parseHex2(line, 2, r) || !parseHex2(line, 4, g) ||
             !parseHex2(line, 6, b) || !parseHex2(line, 8, period))
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
 
         if (period < 1 || period > 99)
         {
-            Diag_incInvalidLedCommand();
+            Diag_inc(DiagId::INVALID_LED_COMMAND);
             return false;
         }
 
         s_led.color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
         s_led.overrideActive = true;
-        s_led.phaseStartMs = millis();
-        s_led.wipePosition = 0;
 
         if (cmd == '2')
         {
@@ -534,11 +661,12 @@ bool Leds_handleCommand(const String &line)
             s_led.currentMode = LedMode::WIPE;
             s_led.periodMs = period * 10; // 01..99 -> 10..990 ms step time
         }
+        restartEffect();
 
         return true;
     }
 
     // Unknown command
-    Diag_incInvalidLedCommand();
+    Diag_inc(DiagId::INVALID_LED_COMMAND);
     return false;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "LineFramer.h"
 
 // LED display modes
 enum class LedMode {
@@ -20,4 +21,4 @@ void Leds_update(unsigned long nowMs);
 
 // Handle LED command from Bluetooth/Serial
 // Returns true if command was valid, false otherwise
-bool Leds_handleCommand(const String& line);
+bool Leds_handleCommand(const LineView& line);
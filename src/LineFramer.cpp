@@ -0,0 +1,161 @@
+#include "LineFramer.h"
+#include "BinaryProtocol.h"
+
+static_assert(BIN_MAX_FRAME_LEN <= LINE_MAX_LEN, "binary frames must fit a line slot");
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// --- LineView ---
+
+bool LineView::operator==(const char *s) const {
+    size_t n = strlen(s);
+    return n == len_ && memcmp(data_, s, n) == 0;
+}
+
+bool LineView::startsWith(const char *prefix) const {
+    size_t n = strlen(prefix);
+    return n <= len_ && memcmp(data_, prefix, n) == 0;
+}
+
+int LineView::indexOf(char c, size_t from) const {
+    for (size_t i = from; i < len_; i++) {
+        if (data_[i] == c) return int(i);
+    }
+    return -1;
+}
+
+LineView LineView::substring(size_t from, size_t to) const {
+    if (to > len_) to = len_;
+    if (from >= to) return LineView(data_ + len_, 0);
+    return LineView(data_ + from, to - from);
+}
+
+long LineView::toInt() const {
+    size_t i = 0;
+    while (i < len_ && isSpace(data_[i])) i++;
+    bool neg = false;
+    if (i < len_ && (data_[i] == '-' || data_[i] == '+')) {
+        neg = (data_[i] == '-');
+        i++;
+    }
+    long v = 0;
+    while (i < len_ && isDigit(data_[i])) {
+        v = v * 10 + (data_[i] - '0');
+        i++;
+    }
+    return neg ? -v : v;
+}
+
+float LineView::toFloat() const {
+    size_t i = 0;
+    while (i < len_ && isSpace(data_[i])) i++;
+    bool neg = false;
+    if (i < len_ && (data_[i] == '-' || data_[i] == '+')) {
+        neg = (data_[i] == '-');
+        i++;
+    }
+    float v = 0.0f;
+    while (i < len_ && isDigit(data_[i])) {
+        v = v * 10.0f + float(data_[i] - '0');
+        i++;
+    }
+    if (i < len_ && data_[i] == '.') {
+        i++;
+        float scale = 0.1f;
+        while (i < len_ && isDigit(data_[i])) {
+            v += float(data_[i] - '0') * scale;
+            scale *= 0.1f;
+            i++;
+        }
+    }
+    return neg ? -v : v;
+}
+
+size_t LineView::printTo(Print &p) const {
+    return p.write(reinterpret_cast<const uint8_t *>(data_), len_);
+}
+
+// --- LineFramer ---
+
+void LineFramer::reset() {
+    head_ = 0;
+    tail_ = 0;
+    count_ = 0;
+    fill_ = 0;
+    binLen_ = 0;
+    discarding_ = false;
+}
+
+LineFramer::PushResult LineFramer::commit(uint8_t len, uint32_t stampUs) {
+    if (count_ >= LINE_RING_SLOTS) return PushResult::DROPPED;
+
+    slots_[head_][len] = '\0';
+    lens_[head_] = len;
+    stamps_[head_] = stampUs;
+    head_ = uint8_t((head_ + 1) % SLOT_COUNT);
+    count_++;
+    return PushResult::LINE;
+}
+
+LineFramer::PushResult LineFramer::pushBinary(uint8_t b, uint32_t stampUs) {
+    slots_[head_][fill_++] = char(b);
+
+    if (fill_ == 1) {
+        binLen_ = BIN_MAX_FRAME_LEN;     // real length known after TYPE
+        return PushResult::NONE;
+    }
+    if (fill_ == 2) {
+        binLen_ = BinProto_frameLength(b);
+        if (binLen_ == 0) {
+            fill_ = 0;
+            return PushResult::BAD_FRAME;
+        }
+    }
+    if (fill_ < binLen_) return PushResult::NONE;
+
+    uint8_t len = fill_;
+    fill_ = 0;
+    binLen_ = 0;
+    return commit(len, stampUs);
+}
+
+LineFramer::PushResult LineFramer::push(char c, uint32_t stampUs) {
+    if (binLen_ != 0 || (fill_ == 0 && !discarding_ && uint8_t(c) == BIN_SYNC)) {
+        return pushBinary(uint8_t(c), stampUs);
+    }
+
+    if (c == '\n' || c == '\r') {
+        uint8_t len = fill_;
+        fill_ = 0;
+        if (discarding_) {
+            discarding_ = false;
+            return PushResult::NONE;
+        }
+        const char *slot = slots_[head_];
+        while (len > 0 && isSpace(slot[len - 1])) len--;
+        if (len == 0) return PushResult::NONE;
+        return commit(len, stampUs);
+    }
+
+    if (discarding_) return PushResult::NONE;
+    if (fill_ == 0 && isSpace(c)) return PushResult::NONE;   // trim leading
+
+    if (fill_ >= LINE_MAX_LEN) {
+        fill_ = 0;
+        discarding_ = true;
+        return PushResult::OVERFLOW;
+    }
+    slots_[head_][fill_++] = c;
+    return PushResult::NONE;
+}
+
+bool LineFramer::pop(LineView &out, uint32_t *stampUs) {
+    if (count_ == 0) return false;
+    out = LineView(slots_[tail_], lens_[tail_]);
+    if (stampUs) *stampUs = stamps_[tail_];
+    tail_ = uint8_t((tail_ + 1) % SLOT_COUNT);
+    count_--;
+    return true;
+}
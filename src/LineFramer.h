@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Max. Nutzlänge einer Kommandozeile (ohne Terminator)
+constexpr uint8_t LINE_MAX_LEN    = 128;  // NFL-Bulk-Zeile mit MAX_NOTCHES Einträgen
+// Anzahl fertiger Zeilen, die pro Quelle gepuffert werden können
+constexpr uint8_t LINE_RING_SLOTS = 8;
+
+// Non-owning, read-only view of a framed command line.
+// Mirrors the subset of the Arduino String API the parsers use, but never
+// allocates: substring() returns another view into the same bytes.
+class LineView : public Printable {
+public:
+    LineView() : data_(""), len_(0) {}
+    LineView(const char *data, size_t len) : data_(data), len_(len) {}
+    LineView(const char *cstr) : data_(cstr), len_(strlen(cstr)) {}
+
+    const char *data() const { return data_; }
+    size_t length() const { return len_; }
+    char operator[](size_t i) const { return i < len_ ? data_[i] : 0; }
+    char charAt(size_t i) const { return (*this)[i]; }
+
+    bool operator==(const char *s) const;
+    bool startsWith(const char *prefix) const;
+    int indexOf(char c, size_t from = 0) const;
+    LineView substring(size_t from) const { return substring(from, len_); }
+    LineView substring(size_t from, size_t to) const;
+
+    // Like String::toInt()/toFloat(): parse a leading number, 0 if none
+    long toInt() const;
+    float toFloat() const;
+
+    size_t printTo(Print &p) const override;
+
+private:
+    const char *data_;
+    size_t len_;
+};
+
+// Fixed-capacity line framer for one byte source.
+// Bytes are assembled directly into a ring of line slots, so completed lines
+// can be handed out as views without copying. Leading/trailing whitespace is
+// trimmed, empty lines are ignored, over-long lines are discarded up to the
+// next terminator.
+// A BIN_SYNC byte at the start of a line switches to length-based framing for
+// one binary frame (see BinaryProtocol.h); the frame is queued as a "line"
+// starting with BIN_SYNC, without terminator or trimming.
+class LineFramer {
+public:
+    enum class PushResult : uint8_t {
+        NONE,       // byte consumed, no line completed
+        LINE,       // a line was completed and queued
+        OVERFLOW,   // line exceeded LINE_MAX_LEN, discarding until terminator
+        DROPPED,    // line completed but all slots were full
+        BAD_FRAME   // binary frame with unknown type, resyncing
+    };
+
+    LineFramer() { reset(); }
+
+    void reset();
+    // stampUs is kept with the line the byte completes (see Latency.h)
+    PushResult push(char c, uint32_t stampUs = 0);
+
+    // Oldest completed line. The view stays valid until the next push().
+    bool pop(LineView &out, uint32_t *stampUs = nullptr);
+    uint8_t pending() const { return count_; }
+
+private:
+    PushResult pushBinary(uint8_t b, uint32_t stampUs);
+    PushResult commit(uint8_t len, uint32_t stampUs);
+
+    // One extra slot: the head slot is always free for incoming bytes
+    static constexpr uint8_t SLOT_COUNT = LINE_RING_SLOTS + 1;
+
+    char    slots_[SLOT_COUNT][LINE_MAX_LEN + 1];
+    uint8_t lens_[SLOT_COUNT];
+    uint32_t stamps_[SLOT_COUNT];
+    uint8_t head_;      // slot currently being filled
+    uint8_t tail_;      // oldest completed slot
+    uint8_t count_;     // completed, not yet popped
+    uint8_t fill_;      // bytes in the head slot
+    uint8_t binLen_;    // expected binary frame length, 0 = text mode
+    bool    discarding_;
+};
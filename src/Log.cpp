@@ -0,0 +1,133 @@
+#include "Log.h"
+#include <atomic>
+
+// Bounded multi-producer/single-consumer ring (per-cell sequence numbers).
+// A cell is free for the producer at position pos when seq == pos and
+// readable for the consumer when seq == pos + 1.
+struct LogCell {
+    std::atomic<uint32_t> seq;
+    const char *fmt;
+    intptr_t argv[LOG_MAX_ARGS];
+    uint8_t level;
+    uint8_t argc;
+};
+
+static LogCell cells[LOG_RING_SIZE];
+static std::atomic<uint32_t> enqueuePos(0);
+static uint32_t dequeuePos = 0;
+static std::atomic<uint32_t> dropped(0);
+static uint32_t droppedReported = 0;
+
+void Log_init() {
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+    dropped.store(0, std::memory_order_relaxed);
+    droppedReported = 0;
+}
+
+void Log_write(uint8_t level, const char *fmt, uint8_t argc, const intptr_t *argv) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    LogCell *cell;
+    for (;;) {
+        cell = &cells[pos & (LOG_RING_SIZE - 1)];
+        int32_t diff = int32_t(cell->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);   // ring full
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->fmt = fmt;
+    cell->level = level;
+    cell->argc = argc > LOG_MAX_ARGS ? LOG_MAX_ARGS : argc;
+    for (uint8_t i = 0; i < cell->argc; i++) {
+        cell->argv[i] = argv[i];
+    }
+    cell->seq.store(pos + 1, std::memory_order_release);
+}
+
+uint32_t Log_getDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// Mini-printf over the stored arguments; returns length incl. CRLF
+static size_t formatRecord(const char *fmt, uint8_t argc, const intptr_t *argv, char *out, size_t cap) {
+    size_t n = 0;
+    uint8_t arg = 0;
+    const size_t limit = cap - 3;   // room for CRLF + NUL
+
+    for (const char *p = fmt; *p && n < limit; p++) {
+        if (*p != '%') {
+            out[n++] = *p;
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            out[n++] = '%';
+            continue;
+        }
+
+        // optional '0' flag and width, then conversion
+        char spec[8] = {'%'};
+        uint8_t s = 1;
+        while ((*p == '0' || isDigit(*p)) && s < 4) spec[s++] = *p++;
+        if (*p == '\0') break;
+
+        intptr_t v = (arg < argc) ? argv[arg++] : 0;
+        int w = 0;
+        switch (*p) {
+            case 'd': spec[s++] = 'l'; spec[s++] = 'd'; w = snprintf(out + n, cap - n, spec, long(v)); break;
+            case 'u': spec[s++] = 'l'; spec[s++] = 'u'; w = snprintf(out + n, cap - n, spec, (unsigned long)v); break;
+            case 'x': spec[s++] = 'l'; spec[s++] = 'X'; w = snprintf(out + n, cap - n, spec, (unsigned long)v); break;
+            case 'c': out[n] = char(v); w = 1; break;
+            case 's': w = snprintf(out + n, cap - n, "%s", v ? reinterpret_cast<const char *>(v) : "(null)"); break;
+            default:  out[n] = *p; w = 1; break;
+        }
+        if (w > 0) n += size_t(w);
+        if (n > limit) n = limit;
+    }
+
+    out[n++] = '\r';
+    out[n++] = '\n';
+    out[n] = '\0';
+    return n;
+}
+
+static bool emit(const char *line, size_t len) {
+    if (Serial.availableForWrite() < int(len)) return false;   // would block
+    Serial.write(reinterpret_cast<const uint8_t *>(line), len);
+    return true;
+}
+
+uint8_t Log_drain(uint8_t maxRecords) {
+    char line[LOG_LINE_MAX];
+    uint8_t written = 0;
+
+    uint32_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported) {
+        intptr_t argv[1] = {intptr_t(lost - droppedReported)};
+        size_t len = formatRecord("[LOG] %u records dropped", 1, argv, line, sizeof(line));
+        if (!emit(line, len)) return 0;
+        droppedReported = lost;
+    }
+
+    while (written < maxRecords) {
+        LogCell &cell = cells[dequeuePos & (LOG_RING_SIZE - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != dequeuePos + 1) break;   // empty
+
+        size_t len = formatRecord(cell.fmt, cell.argc, cell.argv, line, sizeof(line));
+        if (!emit(line, len)) break;   // retry next time, record stays queued
+
+        cell.seq.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+        dequeuePos++;
+        written++;
+    }
+    return written;
+}
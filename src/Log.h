@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Non-blocking log pipeline.
+// LOG_* macros store a compact record (format pointer + up to 6 integer
+// arguments) in a lock-free ring; Log_drain() formats and writes records to
+// Serial from idle time, only as far as the UART TX buffer has room.
+// Records below LOG_LEVEL are removed at compile time.
+//
+// Format strings must be string literals (only the pointer is stored).
+// Supported conversions: %d %u %x %c %s (literal strings only) and %%.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERR  1
+#define LOG_LEVEL_WRN  2
+#define LOG_LEVEL_INF  3
+#define LOG_LEVEL_DBG  4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DBG
+#endif
+
+constexpr uint8_t LOG_RING_SIZE  = 64;   // power of two
+constexpr uint8_t LOG_MAX_ARGS   = 6;
+constexpr uint8_t LOG_LINE_MAX   = 96;   // formatted line incl. CRLF
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+
+void Log_init();
+
+// Producer side (any task/core): never blocks, drops when the ring is full
+void Log_write(uint8_t level, const char *fmt, uint8_t argc, const intptr_t *argv);
+
+// Consumer side (one task): writes up to maxRecords, returns records written
+uint8_t  Log_drain(uint8_t maxRecords);
+uint32_t Log_getDropped();
+
+inline void Log_record(uint8_t level, const char *fmt) {
+    Log_write(level, fmt, 0, nullptr);
+}
+
+template <typename... Args>
+inline void Log_record(uint8_t level, const char *fmt, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    const intptr_t argv[] = {intptr_t(args)...};
+    Log_write(level, fmt, uint8_t(sizeof...(Args)), argv);
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_ERR
+#define LOG_ERR(...) Log_record(LOG_LEVEL_ERR, __VA_ARGS__)
+#else
+#define LOG_ERR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WRN
+#define LOG_WRN(...) Log_record(LOG_LEVEL_WRN, __VA_ARGS__)
+#else
+#define LOG_WRN(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INF
+#define LOG_INF(...) Log_record(LOG_LEVEL_INF, __VA_ARGS__)
+#else
+#define LOG_INF(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DBG
+#define LOG_DBG(...) Log_record(LOG_LEVEL_DBG, __VA_ARGS__)
+#else
+#define LOG_DBG(...) do {} while (0)
+#endif
@@ -0,0 +1,88 @@
+#include "MotionMixer.h"
+
+constexpr int32_t TABLE_STEP = 1L << MIX_TABLE_SHIFT;
+
+static MixCurve curve = MixCurve::LINEAR;
+static uint8_t  expoPercent = MIX_EXPO_DEFAULT;
+
+static int16_t expoTable[MIX_TABLE_POINTS];
+static int16_t userTable[MIX_TABLE_POINTS];
+
+const int16_t *MotionMixer_curveTable = nullptr;
+
+static int32_t tableX(uint8_t i) {
+    int32_t x = int32_t(i) * TABLE_STEP;
+    return x > MIX_FULL_SCALE ? MIX_FULL_SCALE : x;
+}
+
+static void buildExpoTable() {
+    for (uint8_t i = 0; i < MIX_TABLE_POINTS; i++) {
+        int64_t x = tableX(i);
+        int64_t cube = (x * x / MIX_FULL_SCALE) * x / MIX_FULL_SCALE;
+        expoTable[i] = int16_t((x * (100 - expoPercent) + cube * expoPercent) / 100);
+    }
+}
+
+static void selectTable() {
+    switch (curve) {
+        case MixCurve::LINEAR: MotionMixer_curveTable = nullptr;   break;
+        case MixCurve::EXPO:   MotionMixer_curveTable = expoTable; break;
+        case MixCurve::TABLE:  MotionMixer_curveTable = userTable; break;
+    }
+}
+
+void MotionMixer_init() {
+    curve = MixCurve::LINEAR;
+    expoPercent = MIX_EXPO_DEFAULT;
+    buildExpoTable();
+    for (uint8_t i = 0; i < MIX_TABLE_POINTS; i++) {
+        userTable[i] = int16_t(tableX(i));             // identity until configured
+    }
+    selectTable();
+}
+
+void MotionMixer_setCurve(MixCurve c) {
+    curve = c;
+    selectTable();
+}
+
+MixCurve MotionMixer_getCurve() {
+    return curve;
+}
+
+bool MotionMixer_setExpo(uint8_t percent) {
+    if (percent > 100) return false;
+    expoPercent = percent;
+    buildExpoTable();
+    return true;
+}
+
+uint8_t MotionMixer_getExpo() {
+    return expoPercent;
+}
+
+bool MotionMixer_setTablePoint(uint8_t idx, uint16_t permille) {
+    if (idx >= MIX_TABLE_POINTS || permille > 1000) return false;
+    userTable[idx] = int16_t((int32_t(permille) * MIX_FULL_SCALE + 500) / 1000);
+    return true;
+}
+
+uint16_t MotionMixer_getTablePoint(uint8_t idx) {
+    if (idx >= MIX_TABLE_POINTS) return 0;
+    return uint16_t((int32_t(userTable[idx]) * 1000 + MIX_FULL_SCALE / 2) / MIX_FULL_SCALE);
+}
+
+void MotionMixer_dump(Print &p) {
+    p.print(F("[MX] Curve: "));
+    switch (curve) {
+        case MixCurve::LINEAR: p.println(F("LINEAR")); break;
+        case MixCurve::EXPO:   p.print(F("EXPO ")); p.print(expoPercent); p.println(F("%")); break;
+        case MixCurve::TABLE:  p.println(F("TABLE")); break;
+    }
+    p.print(F("[MX] Table (permille):"));
+    for (uint8_t i = 0; i < MIX_TABLE_POINTS; i++) {
+        p.print(' ');
+        p.print(MotionMixer_getTablePoint(i));
+    }
+    p.println();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Integer motion mixer: throttle/steer or track values -> left/right PWM.
+// Pure integer/lookup-table math, so host and ESP32 produce identical output.
+//
+// Inputs are normalized to ±MIX_FULL_SCALE. A response curve (17-point
+// table, linearly interpolated) is applied to each input before mixing.
+// mix/tracks run once per motion command and are inline below; curve
+// configuration lives in MotionMixer.cpp.
+
+constexpr int32_t MIX_FULL_SCALE   = 32767;
+constexpr uint8_t MIX_TABLE_POINTS = 17;     // x = i * 2048, i = 0..16
+constexpr uint8_t MIX_EXPO_DEFAULT = 30;     // % cubic share for EXPO
+constexpr int     MIX_TABLE_SHIFT  = 11;     // 32768 / 16 segments
+
+// ±MIX_FULL_SCALE -> ±MAX_PWM as one unsigned multiply and shift: the scale
+// is MAX_PWM / MIX_FULL_SCALE rounded up in Q(32 - MOTOR_PWM_RES), which
+// truncates exactly like the division for every input (checked by the
+// mixer bench); the product stays below 2^32
+constexpr int      MIX_PWM_SHIFT = 32 - MOTOR_PWM_RES;
+constexpr uint32_t MIX_PWM_SCALE =
+    uint32_t(((uint64_t(MAX_PWM) << MIX_PWM_SHIFT) + MIX_FULL_SCALE - 1) / MIX_FULL_SCALE);
+static_assert(MOTOR_PWM_RES <= 14, "MIX_PWM_SCALE * MIX_FULL_SCALE must fit 32 bits");
+
+enum class MixCurve : uint8_t {
+    LINEAR,
+    EXPO,     // y = (1-e)*x + e*x^3
+    TABLE     // user table (MotionMixer_setTablePoint)
+};
+
+void MotionMixer_init();
+
+void     MotionMixer_setCurve(MixCurve curve);
+MixCurve MotionMixer_getCurve();
+bool     MotionMixer_setExpo(uint8_t percent);                 // 0..100
+uint8_t  MotionMixer_getExpo();
+bool     MotionMixer_setTablePoint(uint8_t idx, uint16_t permille);  // 0..1000
+uint16_t MotionMixer_getTablePoint(uint8_t idx);                // permille
+
+// ASCII motion value 0..99 -> 0..MIX_FULL_SCALE, rounded (constant divisor,
+// compiles to a multiply)
+inline int32_t MotionMixer_fromPercent99(uint8_t value) {
+    return (int32_t(value > 99 ? 99 : value) * MIX_FULL_SCALE + 49) / 99;
+}
+
+// Table of the selected curve, nullptr = LINEAR. Only MotionMixer_setCurve
+// and MotionMixer_init change it (parser task, like the mixing itself).
+extern const int16_t *MotionMixer_curveTable;
+
+inline int32_t MotionMixer_clamp(int32_t v) {
+    if (v >  MIX_FULL_SCALE) return  MIX_FULL_SCALE;
+    if (v < -MIX_FULL_SCALE) return -MIX_FULL_SCALE;
+    return v;
+}
+
+// Curve on ±MIX_FULL_SCALE, symmetric around 0; x already clamped
+inline int32_t MotionMixer_curve(const int16_t *table, int32_t x) {
+    int32_t a = x < 0 ? -x : x;
+    int32_t idx = a >> MIX_TABLE_SHIFT;                 // 0..15
+    int32_t frac = a & ((1L << MIX_TABLE_SHIFT) - 1);
+    int32_t y0 = table[idx];
+    int32_t y1 = table[idx + 1];
+    int32_t y = y0 + (((y1 - y0) * frac) >> MIX_TABLE_SHIFT);
+    return x < 0 ? -y : y;
+}
+
+// ±MIX_FULL_SCALE -> ±MAX_PWM, truncated toward 0 like the former float path
+inline int MotionMixer_toPwm(int32_t v) {
+    uint32_t a = uint32_t(v < 0 ? -v : v);
+    int out = int((a * MIX_PWM_SCALE) >> MIX_PWM_SHIFT);
+    return v < 0 ? -out : out;
+}
+
+// Throttle/steer (±MIX_FULL_SCALE) -> left = T + S, right = T - S (±MAX_PWM)
+inline void MotionMixer_mix(int32_t throttle, int32_t steer, int &outLeft, int &outRight) {
+    int32_t t = MotionMixer_clamp(throttle);
+    int32_t s = MotionMixer_clamp(steer);
+    const int16_t *table = MotionMixer_curveTable;
+    if (table) {
+        t = MotionMixer_curve(table, t);
+        s = MotionMixer_curve(table, s);
+    }
+    outLeft  = MotionMixer_toPwm(MotionMixer_clamp(t + s));
+    outRight = MotionMixer_toPwm(MotionMixer_clamp(t - s));
+}
+
+// Track values (±MIX_FULL_SCALE) -> left/right (±MAX_PWM)
+inline void MotionMixer_tracks(int32_t left, int32_t right, int &outLeft, int &outRight) {
+    int32_t l = MotionMixer_clamp(left);
+    int32_t r = MotionMixer_clamp(right);
+    const int16_t *table = MotionMixer_curveTable;
+    if (table) {
+        l = MotionMixer_curve(table, l);
+        r = MotionMixer_curve(table, r);
+    }
+    outLeft  = MotionMixer_toPwm(l);
+    outRight = MotionMixer_toPwm(r);
+}
+
+void MotionMixer_dump(Print &p);
@@ -0,0 +1,58 @@
+#include "MotorDriver.h"
+#include "Config.h"
+#include "Hal.h"
+
+constexpr uint8_t MOTOR_CHANNELS = 4;
+
+static const uint8_t channelPin[MOTOR_CHANNELS] = {PIN_IN1, PIN_IN2, PIN_IN3, PIN_IN4};
+
+static uint32_t duty[MOTOR_CHANNELS];
+static uint32_t channelWrites = 0;
+static uint32_t channelSkips = 0;
+
+void MotorDriver_init() {
+    for (uint8_t ch = 0; ch < MOTOR_CHANNELS; ch++) {
+        Hal_pwmSetup(ch, MOTOR_PWM_FREQ, MOTOR_PWM_RES);
+        Hal_pwmAttach(channelPin[ch], ch);
+        Hal_pwmWrite(ch, 0);
+        duty[ch] = 0;
+    }
+    channelWrites = 0;
+    channelSkips = 0;
+}
+
+void MotorDriver_write(int left, int right) {
+    uint32_t next[MOTOR_CHANNELS] = {
+        uint32_t(left  > 0 ?  left  : 0),
+        uint32_t(left  < 0 ? -left  : 0),
+        uint32_t(right > 0 ?  right : 0),
+        uint32_t(right < 0 ? -right : 0),
+    };
+
+    // Break-before-make: released inputs (new duty 0) first, raised ones after
+    uint8_t channels[MOTOR_CHANNELS];
+    uint32_t duties[MOTOR_CHANNELS];
+    uint8_t count = 0;
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t ch = 0; ch < MOTOR_CHANNELS; ch++) {
+            if (next[ch] == duty[ch] || (next[ch] == 0) != (pass == 0)) continue;
+            duty[ch] = next[ch];
+            channels[count] = ch;
+            duties[count] = next[ch];
+            count++;
+        }
+    }
+    channelSkips += MOTOR_CHANNELS - count;
+    if (count == 0) return;
+
+    Hal_pwmWriteSync(channels, duties, count);
+    channelWrites += count;
+}
+
+uint32_t MotorDriver_getChannelWrites() {
+    return channelWrites;
+}
+
+uint32_t MotorDriver_getChannelSkips() {
+    return channelSkips;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+// H-bridge output for both drive motors (IN1..IN4 on four LEDC channels).
+// Sign-magnitude drive: forward PWMs IN1/IN3 with IN2/IN4 low, reverse the
+// other way round. All changed duties go out in one Hal_pwmWriteSync call
+// with break-before-make order: inputs dropping to 0 are latched before
+// inputs being raised, so even if a PWM period boundary falls between the
+// latches, one bridge never sees both inputs driven. Unchanged channels are
+// not touched.
+// Control task only.
+
+constexpr uint8_t MOTOR_CH_IN1 = 0;   // left, forward
+constexpr uint8_t MOTOR_CH_IN2 = 1;   // left, reverse
+constexpr uint8_t MOTOR_CH_IN3 = 2;   // right, forward
+constexpr uint8_t MOTOR_CH_IN4 = 3;   // right, reverse
+
+void MotorDriver_init();
+
+// left/right: ±MAX_PWM
+void MotorDriver_write(int left, int right);
+
+// Channel writes issued / skipped as unchanged since init
+uint32_t MotorDriver_getChannelWrites();
+uint32_t MotorDriver_getChannelSkips();
@@ -1,5 +1,7 @@
 #include "NotchFilter.h"
 #include "Config.h"
+#include <atomic>
+#include <string.h>
 
 struct Notch {
     uint32_t id;
@@ -9,54 +11,284 @@ struct Notch {
     bool enabled;
 };
 
-static Notch notches[MAX_NOTCHES];
-static int notchCount = 0;
+struct NotchBank {
+    char name[NOTCH_BANK_NAME_LEN + 1];
+    Notch notches[MAX_NOTCHES];
+    int count;
+    uint8_t table;      // index into tables[]
+};
+
+constexpr int NOTCH_TABLE_LEN = ESC_MAX_US - ESC_OFF_US + 1;
+
+// Everything the control task needs from one bank, precomputed.
+// Forbidden bands (skip mode) are the notch ranges, merged where they
+// overlap; a throttle is inside band i when lo < us < hi.
+struct NotchTable {
+    int16_t out[NOTCH_TABLE_LEN];       // attenuated throttle
+    int8_t  band[NOTCH_TABLE_LEN];      // band index, -1 = outside
+    int16_t bandLo[MAX_NOTCHES];
+    int16_t bandHi[MAX_NOTCHES];
+    uint8_t bandCount;
+    uint8_t bank;                       // owner, selects the band time metrics
+};
+
+// One table per bank plus a spare. Config and rebuilds live on the comms
+// side; the control task only reads the table it acquired for its tick. A
+// rebuild fills the spare, hands the bank's previous table back as spare
+// and, for the active bank, publishes the new pointer. Selecting a bank
+// publishes its finished table.
+//
+// Grace handshake: every pointer switch bumps publishEpoch and stamps the
+// replaced table with it. NotchFilter_acquire() stores the epoch it sees in
+// ackEpoch before loading the pointer, once per control tick. When ackEpoch
+// has reached a table's stamp, the tick that may have used it is over and
+// later ticks only load newer pointers, so the table may be overwritten.
+// Until then a rebuild stays pending and NotchFilter_service() retries it.
+constexpr uint8_t NOTCH_TABLE_COUNT = NOTCH_BANK_COUNT + 1;
+
+static NotchTable tables[NOTCH_TABLE_COUNT];
+static uint32_t retiredAt[NOTCH_TABLE_COUNT];   // epoch the table was unpublished at
+static uint8_t spareTable = NOTCH_BANK_COUNT;
+static uint8_t pendingBanks = 0;                // bitmask: rebuild waits for the spare
+static std::atomic<NotchTable *> activeTable(nullptr);
+static std::atomic<uint32_t> publishEpoch(0);
+static std::atomic<uint32_t> ackEpoch(0);
+static std::atomic<NotchMode> mode(NotchMode::ATTENUATE);
+
+// Time the armed weapon spent inside each band, per bank. Kept outside the
+// tables so a rebuild carries it over to the new bands instead of losing it.
+// Added to by the control task, remapped by the comms side on rebuild.
+static std::atomic<uint32_t> bandTimeUs[NOTCH_BANK_COUNT][MAX_NOTCHES];
+
+// Skip mode: side of the band the ramp is parked at (hysteresis state);
+// band indices are only valid for the table they were taken from
+static int  skipBand = -1;
+static bool skipHigh = false;
+static const NotchTable *skipTable = nullptr;
+
+static NotchBank banks[NOTCH_BANK_COUNT];
+static uint8_t activeBank = 0;
 static uint32_t nextId = 1;
 static int baseThrottleUs = ESC_ARM_US;
-static bool globalEnabled = false;
+static std::atomic<bool> globalEnabled(false);
+
+// Float reference response, evaluated only while building a table
+static int computeResponse(const NotchBank &bank, int inputUs) {
+    if (bank.count == 0) {
+        return inputUs;
+    }
+
+    if (inputUs <= baseThrottleUs + 5) {
+        return inputUs;
+    }
+
+    float delta = float(inputUs - baseThrottleUs);
+    float factor = 1.0f;
+
+    for (int i = 0; i < bank.count; i++) {
+        const Notch &n = bank.notches[i];
+        if (!n.enabled) continue;
+
+        int d = abs(inputUs - n.centerUs);
+        if (d < n.halfWidthUs) {
+            float w = 1.0f - float(d) / float(n.halfWidthUs);
+            float f = 1.0f - n.depth * w;
+            factor *= f;
+        }
+    }
+
+    factor = constrain(factor, 0.0f, 1.0f);
+    int outUs = baseThrottleUs + int(delta * factor + 0.5f);
+    return constrain(outUs, ESC_OFF_US, ESC_MAX_US);
+}
+
+static void buildBands(const NotchBank &bank, NotchTable &t) {
+    int16_t lo[MAX_NOTCHES];
+    int16_t hi[MAX_NOTCHES];
+    uint8_t n = 0;
+
+    // Enabled notch ranges, clipped and sorted by lower edge
+    for (int i = 0; i < bank.count; i++) {
+        const Notch &notch = bank.notches[i];
+        if (!notch.enabled) continue;
+        int l = constrain(notch.centerUs - notch.halfWidthUs, ESC_OFF_US, ESC_MAX_US);
+        int h = constrain(notch.centerUs + notch.halfWidthUs, ESC_OFF_US, ESC_MAX_US);
+        uint8_t j = n++;
+        while (j > 0 && lo[j - 1] > l) {
+            lo[j] = lo[j - 1];
+            hi[j] = hi[j - 1];
+            j--;
+        }
+        lo[j] = int16_t(l);
+        hi[j] = int16_t(h);
+    }
+
+    // Merge overlapping ranges
+    t.bandCount = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (t.bandCount > 0 && lo[i] <= t.bandHi[t.bandCount - 1]) {
+            if (hi[i] > t.bandHi[t.bandCount - 1]) t.bandHi[t.bandCount - 1] = hi[i];
+        } else {
+            t.bandLo[t.bandCount] = lo[i];
+            t.bandHi[t.bandCount] = hi[i];
+            t.bandCount++;
+        }
+    }
+
+    memset(t.band, -1, sizeof(t.band));
+    for (uint8_t i = 0; i < t.bandCount; i++) {
+        for (int us = t.bandLo[i] + 1; us < t.bandHi[i]; us++) {
+            t.band[us - ESC_OFF_US] = int8_t(i);
+        }
+    }
+}
+
+// Moves the band times of the old table to the new band overlapping each old
+// band first (merged bands add up, removed bands lose their time)
+static void remapBandTime(uint8_t b, const NotchTable &from, const NotchTable &to) {
+    uint32_t time[MAX_NOTCHES];
+    for (uint8_t i = 0; i < MAX_NOTCHES; i++) time[i] = bandTimeUs[b][i].exchange(0);
+
+    for (uint8_t i = 0; i < from.bandCount; i++) {
+        if (!time[i]) continue;
+        for (uint8_t j = 0; j < to.bandCount; j++) {
+            if (to.bandLo[j] < from.bandHi[i] && from.bandLo[i] < to.bandHi[j]) {
+                bandTimeUs[b][j].fetch_add(time[i]);
+                break;
+            }
+        }
+    }
+}
+
+static void publish(uint8_t table) {
+    NotchTable *old = activeTable.exchange(&tables[table]);
+    uint32_t epoch = publishEpoch.fetch_add(1) + 1;
+    if (old && old != &tables[table]) retiredAt[old - tables] = epoch;
+}
+
+static bool spareReleased() {
+    return int32_t(ackEpoch.load() - retiredAt[spareTable]) >= 0;
+}
+
+static void buildBank(uint8_t b) {
+    NotchBank &bank = banks[b];
+    NotchTable &next = tables[spareTable];
+    for (int i = 0; i < NOTCH_TABLE_LEN; i++) {
+        next.out[i] = int16_t(computeResponse(bank, ESC_OFF_US + i));
+    }
+    buildBands(bank, next);
+    next.bank = b;
+    remapBandTime(b, tables[bank.table], next);
+
+    uint8_t old = bank.table;
+    bank.table = spareTable;
+    spareTable = old;
+
+    if (b == activeBank) publish(bank.table);
+}
+
+// Rebuilds are queued per bank, so edits that arrive while the spare is
+// still held by the control task collapse into one rebuild
+static void rebuildBank(uint8_t b) {
+    pendingBanks |= uint8_t(1u << b);
+    NotchFilter_service();
+}
+
+static int bandAt(const NotchTable *t, int us) {
+    if (!t || us < ESC_OFF_US || us > ESC_MAX_US) return -1;
+    return t->band[us - ESC_OFF_US];
+}
+
+static bool validSpec(const NotchSpec &s) {
+    return s.halfWidthUs > 0 && s.depth >= 0.0f && s.depth <= 1.0f;
+}
+
+static void setBankName(NotchBank &bank, const char *name, size_t len) {
+    if (len > NOTCH_BANK_NAME_LEN) len = NOTCH_BANK_NAME_LEN;
+    memcpy(bank.name, name, len);
+    bank.name[len] = '\0';
+}
 
 void NotchFilter_init(int baseUs) {
     baseThrottleUs = baseUs;
-    notchCount = 0;
     nextId = 1;
-    globalEnabled = false;
-    for (int i = 0; i < MAX_NOTCHES; i++) {
-        notches[i].enabled = false;
+    globalEnabled.store(false, std::memory_order_relaxed);
+    mode.store(NotchMode::ATTENUATE, std::memory_order_relaxed);
+    skipBand = -1;
+    skipTable = nullptr;
+    activeBank = 0;
+    spareTable = NOTCH_BANK_COUNT;
+    pendingBanks = 0;
+    activeTable.store(nullptr);
+    publishEpoch.store(0);
+    ackEpoch.store(0);
+    for (uint8_t t = 0; t < NOTCH_TABLE_COUNT; t++) {
+        retiredAt[t] = 0;
+        tables[t].bandCount = 0;   // nothing to carry over into the first build
+    }
+    for (uint8_t b = 0; b < NOTCH_BANK_COUNT; b++) {
+        for (uint8_t i = 0; i < MAX_NOTCHES; i++) bandTimeUs[b][i].store(0);
+    }
+
+    for (uint8_t b = 0; b < NOTCH_BANK_COUNT; b++) {
+        NotchBank &bank = banks[b];
+        char name[] = "BANK0";
+        name[4] = char('0' + b);
+        setBankName(bank, name, 5);
+        bank.count = 0;
+        bank.table = b;
+        for (int i = 0; i < MAX_NOTCHES; i++) {
+            bank.notches[i].enabled = false;
+        }
+        rebuildBank(b);
     }
 }
 
 void NotchFilter_setEnabled(bool enabled) {
-    globalEnabled = enabled;
+    globalEnabled.store(enabled, std::memory_order_relaxed);
 }
 
 bool NotchFilter_isEnabled() {
-    return globalEnabled;
+    return globalEnabled.load(std::memory_order_relaxed);
+}
+
+void NotchFilter_setMode(NotchMode m) {
+    mode.store(m, std::memory_order_relaxed);
+}
+
+NotchMode NotchFilter_getMode() {
+    return mode.load(std::memory_order_relaxed);
 }
 
 bool NotchFilter_add(int centerUs, int halfWidthUs, float depth, uint32_t* outId) {
-    if (notchCount >= MAX_NOTCHES) return false;
-    if (halfWidthUs <= 0) return false;
-    if (depth < 0.0f || depth > 1.0f) return false;
+    NotchBank &bank = banks[activeBank];
+    NotchSpec spec = {centerUs, halfWidthUs, depth};
+    if (bank.count >= MAX_NOTCHES) return false;
+    if (!validSpec(spec)) return false;
 
-    notches[notchCount].id = nextId;
-    notches[notchCount].centerUs = centerUs;
-    notches[notchCount].halfWidthUs = halfWidthUs;
-    notches[notchCount].depth = depth;
-    notches[notchCount].enabled = true;
+    Notch &n = bank.notches[bank.count];
+    n.id = nextId;
+    n.centerUs = centerUs;
+    n.halfWidthUs = halfWidthUs;
+    n.depth = depth;
+    n.enabled = true;
 
     if (outId) *outId = nextId;
     nextId++;
-    notchCount++;
+    bank.count++;
+    rebuildBank(activeBank);
     return true;
 }
 
 bool NotchFilter_removeById(uint32_t id) {
-    for (int i = 0; i < notchCount; i++) {
-        if (notches[i].id == id) {
-            for (int j = i; j < notchCount - 1; j++) {
-                notches[j] = notches[j + 1];
+    NotchBank &bank = banks[activeBank];
+    for (int i = 0; i < bank.count; i++) {
+        if (bank.notches[i].id == id) {
+            for (int j = i; j < bank.count - 1; j++) {
+                bank.notches[j] = bank.notches[j + 1];
             }
-            notchCount--;
+            bank.count--;
+            rebuildBank(activeBank);
             return true;
         }
     }
@@ -64,57 +296,171 @@ bool NotchFilter_removeById(uint32_t id) {
 }
 
 void NotchFilter_clear() {
-    notchCount = 0;
+    banks[activeBank].count = 0;
+    rebuildBank(activeBank);
 }
 
 int NotchFilter_getCount() {
-    return notchCount;
+    return banks[activeBank].count;
 }
 
-int NotchFilter_apply(int inputUs, bool active) {
-    if (!globalEnabled || !active || notchCount == 0) {
-        return inputUs;
+bool NotchFilter_loadBank(uint8_t bank, const char *name, size_t nameLen,
+                          const NotchSpec *specs, uint8_t count) {
+    if (bank >= NOTCH_BANK_COUNT || count > MAX_NOTCHES) return false;
+    if (nameLen == 0 || nameLen > NOTCH_BANK_NAME_LEN) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!validSpec(specs[i])) return false;
     }
 
-    if (inputUs <= baseThrottleUs + 5) {
+    NotchBank &b = banks[bank];
+    setBankName(b, name, nameLen);
+    for (uint8_t i = 0; i < count; i++) {
+        Notch &n = b.notches[i];
+        n.id = nextId++;
+        n.centerUs = specs[i].centerUs;
+        n.halfWidthUs = specs[i].halfWidthUs;
+        n.depth = specs[i].depth;
+        n.enabled = true;
+    }
+    b.count = count;
+    rebuildBank(bank);
+    return true;
+}
+
+bool NotchFilter_selectBank(uint8_t bank) {
+    if (bank >= NOTCH_BANK_COUNT) return false;
+    activeBank = bank;
+    publish(banks[bank].table);   // a pending rebuild of this bank publishes again when done
+    return true;
+}
+
+bool NotchFilter_service() {
+    while (pendingBanks) {
+        if (!spareReleased()) return true;
+        uint8_t b = 0;
+        while (!(pendingBanks & (1u << b))) b++;
+        pendingBanks &= uint8_t(~(1u << b));
+        buildBank(b);
+    }
+    return false;
+}
+
+int NotchFilter_findBank(const char *name, size_t len) {
+    for (uint8_t b = 0; b < NOTCH_BANK_COUNT; b++) {
+        if (strlen(banks[b].name) == len && memcmp(banks[b].name, name, len) == 0) return b;
+    }
+    return -1;
+}
+
+uint8_t NotchFilter_getActiveBank() {
+    return activeBank;
+}
+
+// Sequentially consistent on purpose: a table stamped at epoch E is never
+// loaded after the epoch load that reads E
+NotchTable *NotchFilter_acquire() {
+    ackEpoch.store(publishEpoch.load());
+    NotchTable *t = activeTable.load();
+    if (t != skipTable) {   // rebuild or bank switch: band indices changed
+        skipTable = t;
+        skipBand = -1;
+    }
+    return t;
+}
+
+int NotchFilter_apply(const NotchTable *table, int inputUs, bool active) {
+    if (!table || !active || !globalEnabled.load(std::memory_order_relaxed) ||
+        mode.load(std::memory_order_relaxed) != NotchMode::ATTENUATE ||
+        inputUs < ESC_OFF_US || inputUs > ESC_MAX_US) {
         return inputUs;
     }
+    return table->out[inputUs - ESC_OFF_US];
+}
 
-    float delta = float(inputUs - baseThrottleUs);
-    float factor = 1.0f;
+bool NotchFilter_skipActive() {
+    return globalEnabled.load(std::memory_order_relaxed) &&
+           mode.load(std::memory_order_relaxed) == NotchMode::SKIP;
+}
 
-    for (int i = 0; i < notchCount; i++) {
-        if (!notches[i].enabled) continue;
+int NotchFilter_skipTarget(const NotchTable *t, int currentUs, int targetUs) {
+    int b = bandAt(t, targetUs);
+    if (b < 0) {
+        skipBand = -1;
+        return targetUs;
+    }
 
-        int d = abs(inputUs - notches[i].centerUs);
-        if (d < notches[i].halfWidthUs) {
-            float w = 1.0f - float(d) / float(notches[i].halfWidthUs);
-            float f = 1.0f - notches[i].depth * w;
-            factor *= f;
-        }
+    int lo = t->bandLo[b];
+    int hi = t->bandHi[b];
+    int mid = (lo + hi) / 2;
+    if (b != skipBand) {
+        // new band: park on the side we are coming from
+        skipBand = b;
+        skipHigh = (currentUs >= mid);
+    } else if (skipHigh && targetUs < mid - NOTCH_SKIP_HYST_US) {
+        skipHigh = false;
+    } else if (!skipHigh && targetUs > mid + NOTCH_SKIP_HYST_US) {
+        skipHigh = true;
     }
+    return skipHigh ? hi : lo;
+}
 
-    factor = constrain(factor, 0.0f, 1.0f);
-    int outUs = baseThrottleUs + int(delta * factor + 0.5f);
-    return constrain(outUs, ESC_OFF_US, ESC_MAX_US);
+bool NotchFilter_inBand(const NotchTable *t, int us) {
+    return bandAt(t, us) >= 0;
+}
+
+void NotchFilter_trackBandTime(const NotchTable *t, int us, uint32_t dtUs) {
+    int b = bandAt(t, us);
+    if (b >= 0) bandTimeUs[t->bank][b].fetch_add(dtUs, std::memory_order_relaxed);
 }
 
 void NotchFilter_dump(Stream& s) {
+    const NotchBank &bank = banks[activeBank];
     s.print(F("[NF] Global: "));
-    s.println(globalEnabled ? F("ENABLED") : F("DISABLED"));
-    s.print(F("[NF] Active notches: "));
-    s.println(notchCount);
+    s.print(NotchFilter_isEnabled() ? F("ENABLED") : F("DISABLED"));
+    s.println(NotchFilter_getMode() == NotchMode::SKIP ? F(", mode SKIP") : F(", mode ATTENUATE"));
+    s.print(F("[NF] Bank "));
+    s.print(activeBank);
+    s.print(F(" ("));
+    s.print(bank.name);
+    s.print(F("), active notches: "));
+    s.print(bank.count);
+    s.println(pendingBanks & (1u << activeBank) ? F(" (rebuild pending)") : F(""));
     
-    for (int i = 0; i < notchCount; i++) {
+    for (int i = 0; i < bank.count; i++) {
+        const Notch &n = bank.notches[i];
         s.print(F("  ["));
-        s.print(notches[i].id);
+        s.print(n.id);
         s.print(F("] center="));
-        s.print(notches[i].centerUs);
+        s.print(n.centerUs);
         s.print(F("us, halfWidth="));
-        s.print(notches[i].halfWidthUs);
+        s.print(n.halfWidthUs);
         s.print(F("us, depth="));
-        s.print(notches[i].depth, 2);
+        s.print(n.depth, 2);
         s.print(F(", "));
-        s.println(notches[i].enabled ? F("ON") : F("OFF"));
+        s.println(n.enabled ? F("ON") : F("OFF"));
+    }
+
+    // Forbidden bands and time the weapon spent inside them
+    const NotchTable &t = tables[bank.table];
+    for (uint8_t i = 0; i < t.bandCount; i++) {
+        s.print(F("  band "));
+        s.print(t.bandLo[i]);
+        s.print(F(".."));
+        s.print(t.bandHi[i]);
+        s.print(F("us: "));
+        s.print(bandTimeUs[activeBank][i].load(std::memory_order_relaxed) / 1000UL);
+        s.println(F(" ms inside"));
+    }
+}
+
+void NotchFilter_dumpBanks(Stream& s) {
+    for (uint8_t b = 0; b < NOTCH_BANK_COUNT; b++) {
+        s.print(b == activeBank ? F("[NF] *") : F("[NF]  "));
+        s.print(b);
+        s.print(' ');
+        s.print(banks[b].name);
+        s.print(F(": "));
+        s.print(banks[b].count);
+        s.println(F(" notches"));
     }
 }
@@ -2,17 +2,73 @@
 
 #include <Arduino.h>
 
+// Weapon throttle notch filter. The response over ESC_OFF_US..ESC_MAX_US is
+// precomputed into a table whenever the configuration changes, so apply()
+// is a single lookup. Configuration calls belong to one task (the parser);
+// apply() may run concurrently on the control task.
+//
+// Notches live in NOTCH_BANK_COUNT named banks, each with its own finished
+// table. add/remove/clear edit the active bank; selecting a bank only swaps
+// the published table pointer.
+//
+// The control task acquires the published table once per tick and passes it
+// to the per-tick calls below. A table that was replaced is only rebuilt
+// into after the control task has acquired again; until then the rebuild
+// is pending and NotchFilter_service() (comms loop) finishes it.
+
 constexpr int MAX_NOTCHES = 8;
+constexpr uint8_t NOTCH_BANK_COUNT    = 4;
+constexpr uint8_t NOTCH_BANK_NAME_LEN = 8;
+
+// ATTENUATE: apply() scales throttle down near each notch centre.
+// SKIP: notch ranges are forbidden bands; the weapon ramp parks at a band
+// edge instead of settling inside and crosses bands at the skip rate.
+enum class NotchMode : uint8_t {
+    ATTENUATE,
+    SKIP
+};
+
+struct NotchSpec {
+    int centerUs;
+    int halfWidthUs;
+    float depth;
+};
 
 void NotchFilter_init(int baseUs);
 void NotchFilter_setEnabled(bool enabled);
 bool NotchFilter_isEnabled();
+void NotchFilter_setMode(NotchMode mode);
+NotchMode NotchFilter_getMode();
 
 bool NotchFilter_add(int centerUs, int halfWidthUs, float depth, uint32_t* outId = nullptr);
 bool NotchFilter_removeById(uint32_t id);
 void NotchFilter_clear();
 int  NotchFilter_getCount();
 
-int  NotchFilter_apply(int inputUs, bool active);
+// Replace a whole bank (validated first, nothing changes on error)
+bool NotchFilter_loadBank(uint8_t bank, const char *name, size_t nameLen,
+                          const NotchSpec *specs, uint8_t count);
+bool NotchFilter_selectBank(uint8_t bank);
+int  NotchFilter_findBank(const char *name, size_t len);   // -1 if unknown
+uint8_t NotchFilter_getActiveBank();
+
+// Comms side: finishes pending rebuilds, true while some still wait
+bool NotchFilter_service();
+
+// Control task, once per tick; acknowledges all earlier table switches
+struct NotchTable;
+NotchTable *NotchFilter_acquire();
+
+int  NotchFilter_apply(const NotchTable *table, int inputUs, bool active);   // ATTENUATE mode only
+
+// Skip mode (control task)
+bool NotchFilter_skipActive();
+// targetUs, or the edge of the forbidden band containing it. The edge only
+// changes sides once the target is NOTCH_SKIP_HYST_US past the band middle.
+int  NotchFilter_skipTarget(const NotchTable *table, int currentUs, int targetUs);
+bool NotchFilter_inBand(const NotchTable *table, int us);
+// Per-bank time inside each band; survives rebuilds and bank switches
+void NotchFilter_trackBandTime(const NotchTable *table, int us, uint32_t dtUs);
 
 void NotchFilter_dump(Stream& s);
+void NotchFilter_dumpBanks(Stream& s);
@@ -0,0 +1,74 @@
+#include "Perf.h"
+#include "Config.h"
+#include <atomic>
+
+static Histogram hist[uint8_t(PerfId::COUNT)];
+static std::atomic<uint32_t> resetMask(0);
+
+static const char *const PERF_NAMES[uint8_t(PerfId::COUNT)] = {
+    "tick", "drive", "weapon", "notch", "failsafe", "poll", "parse", "leds"
+};
+
+void Perf_init() {
+    for (uint8_t i = 0; i < uint8_t(PerfId::COUNT); i++) Histogram_clear(hist[i]);
+    resetMask.store(0, std::memory_order_relaxed);
+}
+
+void Perf_record(PerfId id, uint32_t cycles) {
+    uint8_t i = uint8_t(id);
+    uint32_t bit = 1UL << i;
+    if (resetMask.load(std::memory_order_relaxed) & bit) {
+        Histogram_clear(hist[i]);
+        resetMask.fetch_and(~bit, std::memory_order_relaxed);
+    }
+    Histogram_add(hist[i], cycles);
+}
+
+void Perf_reset() {
+    resetMask.store((1UL << uint8_t(PerfId::COUNT)) - 1, std::memory_order_relaxed);
+}
+
+#if PERF_ENABLED
+static uint32_t cyclesToNs(uint64_t cycles) {
+    uint64_t ns = cycles * 1000ULL / Hal_cycleFreqMHz();
+    return ns > UINT32_MAX ? UINT32_MAX : uint32_t(ns);
+}
+#endif
+
+void Perf_dump(Print &p) {
+#if PERF_ENABLED
+    for (uint8_t i = 0; i < uint8_t(PerfId::COUNT); i++) {
+        const Histogram &h = hist[i];
+        if (h.count == 0 || (resetMask.load(std::memory_order_relaxed) & (1UL << i))) continue;
+
+        p.print(F("[PERF] "));
+        p.print(PERF_NAMES[i]);
+        p.print(F(" n="));
+        p.print(h.count);
+        p.print(F(" min="));
+        p.print(cyclesToNs(h.min));
+        p.print(F(" avg="));
+        p.print(cyclesToNs(h.sum / h.count));
+        p.print(F(" p99="));
+        p.print(cyclesToNs(Histogram_percentile99(h)));
+        p.print(F(" max="));
+        p.print(cyclesToNs(h.max));
+        p.println(F(" ns"));
+    }
+
+    // Worst control step against the tick period
+    const Histogram &tick = hist[uint8_t(PerfId::CONTROL_TICK)];
+    if (tick.count > 0) {
+        uint32_t maxUs = cyclesToNs(tick.max) / 1000U;
+        p.print(F("[PERF] budget: tick max="));
+        p.print(maxUs);
+        p.print(F("us of "));
+        p.print(CONTROL_PERIOD_US);
+        p.print(F("us ("));
+        p.print(uint32_t(uint64_t(maxUs) * 100U / CONTROL_PERIOD_US));
+        p.println(F("%)"));
+    }
+#else
+    p.println(F("[PERF] disabled (PERF_ENABLED=0)"));
+#endif
+}
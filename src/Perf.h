@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Hal.h"
+#include "Histogram.h"
+
+// Execution-time histograms per module step.
+// PERF_SCOPE(id) measures the enclosing block in CPU cycles (Hal_cycleCount)
+// and records it in a log-scale Histogram (p99 within about 25%, min/avg/max
+// exact).
+//
+// Each id is recorded by one task only (control or comms side); PERF? may
+// read a histogram while it is being updated and then shows a snapshot that
+// is off by one sample. PERF_ENABLED=0 removes all scopes at compile time.
+
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+enum class PerfId : uint8_t {
+    CONTROL_TICK,      // whole control step
+    DRIVE_UPDATE,
+    WEAPON_UPDATE,
+    NOTCH_APPLY,
+    FAILSAFE_UPDATE,
+    COMMS_POLL,        // BluetoothComm_poll
+    PARSER_LINE,       // CommandParser_handleLine
+    LEDS_UPDATE,
+    COUNT
+};
+
+void Perf_init();
+void Perf_record(PerfId id, uint32_t cycles);
+void Perf_reset();              // any task; each histogram clears on its next record
+void Perf_dump(Print &p);
+
+class PerfScope {
+public:
+    explicit PerfScope(PerfId id) : id_(id), start_(Hal_cycleCount()) {}
+    ~PerfScope() { Perf_record(id_, Hal_cycleCount() - start_); }
+
+private:
+    PerfId id_;
+    uint32_t start_;
+};
+
+#if PERF_ENABLED
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b)  PERF_CONCAT_(a, b)
+#define PERF_SCOPE(id)     PerfScope PERF_CONCAT(perfScope_, __LINE__)(id)
+#else
+#define PERF_SCOPE(id)     do {} while (0)
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Bounded single-producer/single-consumer ring, lock-free.
+// push() only from the producer task, pop() only from the consumer task;
+// head/tail are published with release/acquire so the slot contents are
+// visible before the index moves. One slot stays empty to tell full from empty.
+template <typename T, uint16_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+public:
+    SpscQueue() : head_(0), tail_(0) {}
+
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    // Producer side: false when full (item not queued)
+    bool push(const T &item) {
+        uint16_t head = head_.load(std::memory_order_relaxed);
+        uint16_t next = uint16_t((head + 1) & (N - 1));
+        if (next == tail_.load(std::memory_order_acquire)) return false;
+        slots_[head] = item;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: false when empty
+    bool pop(T &out) {
+        uint16_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = slots_[tail];
+        tail_.store(uint16_t((tail + 1) & (N - 1)), std::memory_order_release);
+        return true;
+    }
+
+    uint16_t size() const {
+        return uint16_t((head_.load(std::memory_order_acquire) -
+                         tail_.load(std::memory_order_acquire)) & (N - 1));
+    }
+
+private:
+    T slots_[N];
+    std::atomic<uint16_t> head_;
+    std::atomic<uint16_t> tail_;
+};
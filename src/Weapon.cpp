@@ -3,27 +3,35 @@
 #include "DebugIO.h"
 #include "Diagnostics.h"
 #include "NotchFilter.h"
+#include "EscOutput.h"
+#include "WeaponRamp.h"
+#include "Hal.h"
+#include "Log.h"
+#include "Perf.h"
 #include <Arduino.h>
+#include <atomic>
 
-static WeaponState weaponState       = WeaponState::DISARMED;
+// State/Target werden auch von Leds (Comms-Core) gelesen
+static std::atomic<WeaponState> weaponState(WeaponState::DISARMED);
 static unsigned long weaponArmStartMs = 0;
 
 static int currentWeaponUs = ESC_OFF_US;
-static int targetWeaponUs  = ESC_OFF_US;
-
-static float weaponRateUpUsPerMs   = 0.0f;
-static float weaponRateDownUsPerMs = 0.0f;
+static int outputWeaponUs = ESC_OFF_US;   // nach dem Notch-Filter, zuletzt an den ESC
+static std::atomic<int> targetWeaponUs(ESC_OFF_US);
+static uint32_t pendingRxUs = LATENCY_NO_STAMP;   // Stempel des zuletzt angenommenen Kommandos
 
 static unsigned long lastWeaponDebugMs = 0;
 
-static uint32_t usToDuty(int us) {
-    uint32_t maxDuty   = (1U << WEAPON_PWM_RES) - 1U;
-    float periodUs     = 1000000.0f / float(WEAPON_PWM_FREQ); // ~20000 us
-    float dutyFraction = float(us) / periodUs;
-    if (dutyFraction < 0.0f) dutyFraction = 0.0f;
-    if (dutyFraction > 1.0f) dutyFraction = 1.0f;
-    return uint32_t(dutyFraction * maxDuty);
+#if LOG_LEVEL >= LOG_LEVEL_DBG
+static const char *weaponStateName(WeaponState s) {
+    switch (s) {
+        case WeaponState::DISARMED: return "DISARMED";
+        case WeaponState::ARMING:   return "ARMING";
+        case WeaponState::ARMED:    return "ARMED";
+    }
+    return "?";
 }
+#endif
 
 WeaponState Weapon_getState() {
     return weaponState;
@@ -33,63 +41,107 @@ int Weapon_getTargetThrottleUs() {
     return targetWeaponUs;
 }
 
+int Weapon_getCurrentUs() {
+    return currentWeaponUs;
+}
+
+int Weapon_getOutputUs() {
+    return outputWeaponUs;
+}
+
 void Weapon_init() {
-    pinMode(PIN_LED_ARM, OUTPUT);
-    digitalWrite(PIN_LED_ARM, LOW);
+    Hal_pinOutput(PIN_LED_ARM);
+    Hal_digitalWrite(PIN_LED_ARM, false);
 
     DebugIO_setWeaponActive(false);
 
-    ledcSetup(WEAPON_CHANNEL, WEAPON_PWM_FREQ, WEAPON_PWM_RES);
-    ledcAttachPin(PIN_WEAPON, WEAPON_CHANNEL);
-
-    weaponRateUpUsPerMs   = float(ESC_MAX_US - ESC_OFF_US) / float(WEAPON_RAMP_UP_TIME_MS);
-    weaponRateDownUsPerMs = float(ESC_MAX_US - ESC_OFF_US) / float(WEAPON_RAMP_DOWN_TIME_MS);
+    if (!EscOutput_init(WEAPON_ESC_PROTOCOL)) {
+        Diag_inc(DiagId::ESC_PROTOCOL_FAILED);
+        LOG_ERR("[ERR] Weapon: ESC protocol %s failed to start, using PWM50",
+                EscOutput_protocolName(WEAPON_ESC_PROTOCOL));
+    }
 
+    WeaponRamp_init(ESC_OFF_US);
     currentWeaponUs = ESC_OFF_US;
+    outputWeaponUs  = ESC_OFF_US;
     targetWeaponUs  = ESC_OFF_US;
-    ledcWrite(WEAPON_CHANNEL, usToDuty(currentWeaponUs));
+    pendingRxUs     = LATENCY_NO_STAMP;
 
     weaponState        = WeaponState::DISARMED;
     weaponArmStartMs   = 0;
-    lastWeaponDebugMs  = millis();
+    lastWeaponDebugMs  = Hal_millis();
 
     NotchFilter_init(ESC_ARM_US);
 }
 
-void Weapon_armRequest() {
+void Weapon_armRequest(uint32_t rxUs) {
     if (weaponState == WeaponState::DISARMED) {
+        pendingRxUs      = rxUs;
         weaponState      = WeaponState::ARMING;
-        weaponArmStartMs = millis();
+        weaponArmStartMs = Hal_millis();
         targetWeaponUs   = ESC_ARM_US;
-        digitalWrite(PIN_LED_ARM, HIGH);
-        Serial.println(F("[DBG] Weapon: ARMING requested"));
+        Hal_digitalWrite(PIN_LED_ARM, true);
+        LOG_DBG("[DBG] Weapon: ARMING requested");
     }
 }
 
-void Weapon_disarm() {
+void Weapon_disarm(uint32_t rxUs) {
+    pendingRxUs    = rxUs;
     weaponState    = WeaponState::DISARMED;
     targetWeaponUs = ESC_OFF_US;
-    digitalWrite(PIN_LED_ARM, LOW);
+    Hal_digitalWrite(PIN_LED_ARM, false);
     DebugIO_setWeaponActive(false);
-    Serial.println(F("[DBG] Weapon: DISARMED"));
+    LOG_DBG("[DBG] Weapon: DISARMED");
 }
 
-void Weapon_fullThrottle() {
+void Weapon_fullThrottle(uint32_t rxUs) {
     if (weaponState == WeaponState::ARMED) {
         targetWeaponUs = ESC_MAX_US;
-        Serial.println(F("[DBG] Weapon: FULL THROTTLE"));
+        pendingRxUs    = rxUs;
+        LOG_DBG("[DBG] Weapon: FULL THROTTLE");
     } else {
-        Serial.println(F("[DBG] Weapon_fullThrottle ignored (not ARMED)"));
+        LOG_DBG("[DBG] Weapon_fullThrottle ignored (not ARMED)");
     }
 }
 
-void Weapon_idle() {
+void Weapon_idle(uint32_t rxUs) {
     if (weaponState == WeaponState::ARMED) {
         targetWeaponUs = ESC_ARM_US;
-        Serial.println(F("[DBG] Weapon: IDLE"));
+        pendingRxUs    = rxUs;
+        LOG_DBG("[DBG] Weapon: IDLE");
     } else {
-        Serial.println(F("[DBG] Weapon_idle ignored (not ARMED)"));
+        LOG_DBG("[DBG] Weapon_idle ignored (not ARMED)");
+    }
+}
+
+bool Weapon_setThrottle(int us, uint32_t rxUs) {
+    if (weaponState != WeaponState::ARMED) {
+        LOG_DBG("[DBG] Weapon_setThrottle ignored (not ARMED)");
+        return false;
     }
+    if (us < ESC_ARM_US) us = ESC_ARM_US;
+    if (us > ESC_MAX_US) us = ESC_MAX_US;
+    targetWeaponUs = us;
+    pendingRxUs    = rxUs;
+    LOG_DBG("[DBG] Weapon: THROTTLE %dus", us);
+    return true;
+}
+
+bool Weapon_setEscProtocol(EscProtocol protocol) {
+    if (weaponState != WeaponState::DISARMED) {
+        LOG_WRN("[WPN] ESC protocol change refused (weapon not DISARMED)");
+        return false;
+    }
+    currentWeaponUs = ESC_OFF_US;
+    WeaponRamp_rebase(ESC_OFF_US);
+    if (!EscOutput_setProtocol(protocol)) {
+        Diag_inc(DiagId::ESC_PROTOCOL_FAILED);
+        LOG_ERR("[WPN] ESC protocol %s failed to start, rejected (PWM50 active)",
+                EscOutput_protocolName(protocol));
+        return false;
+    }
+    LOG_INF("[WPN] ESC protocol %s", EscOutput_protocolName(protocol));
+    return true;
 }
 
 void Weapon_updateArming(unsigned long nowMs) {
@@ -107,19 +159,19 @@ void Weapon_updateArming(unsigned long nowMs) {
                 if (abs(currentWeaponUs - ESC_ARM_US) <= 20) {
                     weaponState = WeaponState::ARMED;
                     targetWeaponUs = ESC_ARM_US;
-                    Serial.println(F("[DBG] Weapon: ARMED"));
+                    LOG_DBG("[DBG] Weapon: ARMED");
                 } else {
                     // Arming fehlgeschlagen -> Failsafe: disarm + Fehlerzähler
                     Weapon_disarm();
-                    Diag_incWeaponArmingTimeout();
-                    Serial.println(F("[ERR] Weapon: ARming failed (PWM not at ARM level)"));
+                    Diag_inc(DiagId::WEAPON_ARMING_TIMEOUT);
+                    LOG_ERR("[ERR] Weapon: ARming failed (PWM not at ARM level)");
                 }
             }
             // Sicherheitsnetz: wenn aus irgendeinem Grund extrem lange im ARMING
             else if (elapsed > (WEAPON_ARM_PULSE_TIME_MS * 3UL)) {
                 Weapon_disarm();
-                Diag_incWeaponArmingTimeout();
-                Serial.println(F("[ERR] Weapon: ARming timeout -> DISARM"));
+                Diag_inc(DiagId::WEAPON_ARMING_TIMEOUT);
+                LOG_ERR("[ERR] Weapon: ARming timeout -> DISARM");
             }
             break;
         }
@@ -130,18 +182,34 @@ void Weapon_updateArming(unsigned long nowMs) {
     }
 }
 
-void Weapon_update(unsigned long dtMs, unsigned long nowMs) {
-    if (dtMs == 0) return;
+void Weapon_update(uint32_t dtUs, unsigned long nowMs) {
+    // Notch-Tabelle einmal pro Takt holen (quittiert zugleich Tabellenwechsel)
+    NotchTable *notches = NotchFilter_acquire();
+    if (dtUs == 0) return;
 
-    int before = currentWeaponUs;
+    int goalUs = targetWeaponUs;
 
-    if (currentWeaponUs < targetWeaponUs) {
-        currentWeaponUs += int(weaponRateUpUsPerMs * float(dtMs));
-        if (currentWeaponUs > targetWeaponUs) currentWeaponUs = targetWeaponUs;
-    } else if (currentWeaponUs > targetWeaponUs) {
-        currentWeaponUs -= int(weaponRateDownUsPerMs * float(dtMs));
-        if (currentWeaponUs < targetWeaponUs) currentWeaponUs = targetWeaponUs;
+    // Skip-Band-Modus: nie in einem verbotenen Band einschwingen
+    if (weaponState == WeaponState::ARMED && NotchFilter_skipActive()) {
+        goalUs = NotchFilter_skipTarget(notches, currentWeaponUs, goalUs);
+    }
+
+    int next = WeaponRamp_step(goalUs, dtUs);
+
+    // Bänder mit der schnellen Rate durchqueren; die Rampe setzt danach
+    // an der neuen Position wieder an
+    if (weaponState == WeaponState::ARMED && NotchFilter_skipActive() && next != goalUs &&
+        (NotchFilter_inBand(notches, currentWeaponUs) || NotchFilter_inBand(notches, next))) {
+        int skipStep = int(uint32_t(WEAPON_SKIP_RATE_US_PER_MS) * dtUs / 1000UL);
+        int dir = (goalUs > currentWeaponUs) ? 1 : -1;
+        int skipped = currentWeaponUs + dir * skipStep;
+        if ((skipped - goalUs) * dir > 0) skipped = goalUs;
+        if ((skipped - next) * dir > 0) {
+            next = skipped;
+            WeaponRamp_rebase(next);
+        }
     }
+    currentWeaponUs = next;
 
     // Bounds-Sicherheit
     if (currentWeaponUs < ESC_OFF_US) currentWeaponUs = ESC_OFF_US;
@@ -149,26 +217,34 @@ void Weapon_update(unsigned long dtMs, unsigned long nowMs) {
 
     // Notch Filter anwenden (nur wenn ARMED und über Idle)
     bool filterActive = (weaponState == WeaponState::ARMED && currentWeaponUs > ESC_ARM_US + 5);
-    int outputUs = NotchFilter_apply(currentWeaponUs, filterActive);
+    int outputUs;
+    {
+        PERF_SCOPE(PerfId::NOTCH_APPLY);
+        outputUs = NotchFilter_apply(notches, currentWeaponUs, filterActive);
+    }
+
+    if (weaponState == WeaponState::ARMED) {
+        NotchFilter_trackBandTime(notches, currentWeaponUs, dtUs);
+    }
 
-    if (currentWeaponUs != before) {
-        ledcWrite(WEAPON_CHANNEL, usToDuty(outputUs));
+    // Auf den Ausgang vergleichen: Bankwechsel oder Notch-Änderungen bei
+    // konstanter Rampe müssen den ESC sofort erreichen
+    if (outputUs != outputWeaponUs) {
+        EscOutput_writeUs(outputUs);
+        // Neues Ziel hat mit diesem Schritt den ESC erreicht
+        Latency_record(LatencyId::WEAPON, pendingRxUs);
+        outputWeaponUs = outputUs;
 
         if ((nowMs - lastWeaponDebugMs) >= 100UL) {
             lastWeaponDebugMs = nowMs;
-            Serial.print(F("[DBG] Weapon us="));
-            Serial.print(currentWeaponUs);
-            Serial.print(F(" target="));
-            Serial.print(targetWeaponUs);
-            Serial.print(F(" state="));
-            switch (weaponState) {
-                case WeaponState::DISARMED: Serial.println(F("DISARMED")); break;
-                case WeaponState::ARMING:   Serial.println(F("ARMING"));   break;
-                case WeaponState::ARMED:    Serial.println(F("ARMED"));    break;
-            }
+            LOG_DBG("[DBG] Weapon us=%d target=%d state=%s",
+                    currentWeaponUs, targetWeaponUs.load(), weaponStateName(weaponState));
         }
     }
 
+    // Kommando ohne Änderung am Ausgang (W bei Vollgas, gleiches WT=, geparkt): nicht messen
+    pendingRxUs = LATENCY_NO_STAMP;
+
     // Debug Pin: aktiv, wenn Waffe ARMED und Target > Idle
     if (weaponState == WeaponState::ARMED && targetWeaponUs > ESC_ARM_US + 10) {
         DebugIO_setWeaponActive(true);
@@ -2,15 +2,22 @@
 
 #include <Arduino.h>
 #include "State.h"
+#include "Config.h"
+#include "Latency.h"
 
 void Weapon_init();
-void Weapon_armRequest();
-void Weapon_disarm();
-void Weapon_fullThrottle();
-void Weapon_idle();
+// rxUs: Framing-Zeitstempel des Kommandos für die Latenzmessung (Latency.h)
+void Weapon_armRequest(uint32_t rxUs = LATENCY_NO_STAMP);
+void Weapon_disarm(uint32_t rxUs = LATENCY_NO_STAMP);
+void Weapon_fullThrottle(uint32_t rxUs = LATENCY_NO_STAMP);
+void Weapon_idle(uint32_t rxUs = LATENCY_NO_STAMP);
+bool Weapon_setThrottle(int us, uint32_t rxUs = LATENCY_NO_STAMP);  // ESC_ARM_US..ESC_MAX_US, nur ARMED
+bool Weapon_setEscProtocol(EscProtocol protocol);  // nur im Zustand DISARMED
 
 void Weapon_updateArming(unsigned long nowMs);
-void Weapon_update(unsigned long dtMs, unsigned long nowMs);
+void Weapon_update(uint32_t dtUs, unsigned long nowMs);  // dtUs: fester Steuertakt
 
 WeaponState Weapon_getState();
 int Weapon_getTargetThrottleUs();  // Get current target throttle (for LED status)
+int Weapon_getCurrentUs();         // Rampenausgang, nur Control-Task
+int Weapon_getOutputUs();          // zuletzt an den ESC geschrieben, nur Control-Task
@@ -0,0 +1,131 @@
+#include "WeaponRamp.h"
+#include "Config.h"
+
+constexpr uint32_t Q16_ONE = 1UL << 16;
+constexpr int RAMP_RANGE_US = ESC_MAX_US - ESC_OFF_US;
+
+static RampProfile profileUp   = RampProfile::LINEAR;
+static RampProfile profileDown = RampProfile::LINEAR;
+static uint32_t table[RAMP_TABLE_POINTS];      // Q16 output at progress i/16
+
+static int currentUs = ESC_OFF_US;
+static int startUs   = ESC_OFF_US;
+static int goalUs    = ESC_OFF_US;
+static uint32_t durationUs = 0;
+static uint32_t elapsedUs  = 0;
+
+static uint32_t permilleToQ16(uint16_t permille) {
+    return (uint32_t(permille) * Q16_ONE + 500) / 1000;
+}
+
+static uint32_t shape(RampProfile profile, uint32_t p) {
+    switch (profile) {
+        case RampProfile::LINEAR:
+            return p;
+        case RampProfile::SCURVE: {
+            uint64_t p2 = (uint64_t(p) * p) >> 16;
+            return uint32_t((p2 * (3 * Q16_ONE - 2 * p)) >> 16);
+        }
+        case RampProfile::TABLE: {
+            uint32_t idx = p >> 12;                    // 16 segments
+            if (idx >= RAMP_TABLE_POINTS - 1) return table[RAMP_TABLE_POINTS - 1];
+            uint32_t frac = p & 0x0FFF;
+            int32_t y0 = int32_t(table[idx]);
+            int32_t y1 = int32_t(table[idx + 1]);
+            return uint32_t(y0 + (((y1 - y0) * int32_t(frac)) >> 12));
+        }
+    }
+    return p;
+}
+
+static void startSegment(int fromUs, int toUs) {
+    startUs = fromUs;
+    goalUs = toUs;
+    elapsedUs = 0;
+
+    uint32_t rampMs = (toUs > fromUs) ? WEAPON_RAMP_UP_TIME_MS : WEAPON_RAMP_DOWN_TIME_MS;
+    uint32_t dist = uint32_t(toUs > fromUs ? toUs - fromUs : fromUs - toUs);
+    durationUs = uint32_t(uint64_t(dist) * rampMs * 1000ULL / RAMP_RANGE_US);
+}
+
+void WeaponRamp_init(int us) {
+    profileUp = RampProfile::LINEAR;
+    profileDown = RampProfile::LINEAR;
+    for (uint8_t i = 0; i < RAMP_TABLE_POINTS; i++) {
+        table[i] = uint32_t(i) << 12;             // identity until configured
+    }
+    currentUs = us;
+    startSegment(us, us);
+}
+
+void WeaponRamp_setProfile(bool up, RampProfile profile) {
+    (up ? profileUp : profileDown) = profile;
+}
+
+RampProfile WeaponRamp_getProfile(bool up) {
+    return up ? profileUp : profileDown;
+}
+
+bool WeaponRamp_setTablePoint(uint8_t idx, uint16_t permille) {
+    if (idx >= RAMP_TABLE_POINTS || permille > 1000) return false;
+    table[idx] = permilleToQ16(permille);
+    return true;
+}
+
+uint16_t WeaponRamp_getTablePoint(uint8_t idx) {
+    if (idx >= RAMP_TABLE_POINTS) return 0;
+    return uint16_t((table[idx] * 1000 + Q16_ONE / 2) >> 16);
+}
+
+int WeaponRamp_step(int goal, uint32_t dtUs) {
+    if (goal != goalUs) startSegment(currentUs, goal);
+    if (currentUs == goalUs) return currentUs;
+
+    elapsedUs += dtUs;
+    if (elapsedUs >= durationUs) {
+        currentUs = goalUs;
+        return currentUs;
+    }
+
+    uint32_t p = uint32_t((uint64_t(elapsedUs) << 16) / durationUs);
+    uint32_t s = shape(goalUs > startUs ? profileUp : profileDown, p);
+    if (s > Q16_ONE) s = Q16_ONE;
+    currentUs = startUs + int(((int64_t(goalUs) - startUs) * int64_t(s)) / int64_t(Q16_ONE));
+    return currentUs;
+}
+
+void WeaponRamp_rebase(int us) {
+    currentUs = us;
+    startSegment(us, goalUs);
+}
+
+int WeaponRamp_current() {
+    return currentUs;
+}
+
+static const __FlashStringHelper *profileName(RampProfile p) {
+    switch (p) {
+        case RampProfile::LINEAR: return F("LINEAR");
+        case RampProfile::SCURVE: return F("SCURVE");
+        case RampProfile::TABLE:  return F("TABLE");
+    }
+    return F("?");
+}
+
+void WeaponRamp_dump(Print &p) {
+    p.print(F("[WR] Up: "));
+    p.print(profileName(profileUp));
+    p.print(F(" ("));
+    p.print(WEAPON_RAMP_UP_TIME_MS);
+    p.print(F(" ms), Down: "));
+    p.print(profileName(profileDown));
+    p.print(F(" ("));
+    p.print(WEAPON_RAMP_DOWN_TIME_MS);
+    p.println(F(" ms)"));
+    p.print(F("[WR] Table (permille):"));
+    for (uint8_t i = 0; i < RAMP_TABLE_POINTS; i++) {
+        p.print(' ');
+        p.print(WeaponRamp_getTablePoint(i));
+    }
+    p.println();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fixed-point weapon throttle ramp.
+// Every change of the goal starts a segment from the current throttle whose
+// duration is proportional to the distance: the full ESC_OFF_US..ESC_MAX_US
+// range takes exactly WEAPON_RAMP_UP_TIME_MS / WEAPON_RAMP_DOWN_TIME_MS.
+// Elapsed time is accumulated in whole microseconds, so nothing is lost to
+// truncation and any dt advances the ramp. The segment progress (Q16) is
+// shaped by the profile selected for the direction.
+// Control task only.
+
+constexpr uint8_t RAMP_TABLE_POINTS = 17;      // progress i/16, i = 0..16
+
+enum class RampProfile : uint8_t {
+    LINEAR,
+    SCURVE,     // smoothstep 3p^2 - 2p^3
+    TABLE       // user table (WeaponRamp_setTablePoint)
+};
+
+void WeaponRamp_init(int us);
+void WeaponRamp_setProfile(bool up, RampProfile profile);
+RampProfile WeaponRamp_getProfile(bool up);
+bool WeaponRamp_setTablePoint(uint8_t idx, uint16_t permille);   // 0..1000
+uint16_t WeaponRamp_getTablePoint(uint8_t idx);
+
+// Advance towards goalUs by dtUs, returns the new throttle
+int  WeaponRamp_step(int goalUs, uint32_t dtUs);
+
+// Throttle was moved from outside (skip band crossing): continue from us
+void WeaponRamp_rebase(int us);
+int  WeaponRamp_current();
+
+void WeaponRamp_dump(Print &p);
@@ -9,45 +9,66 @@
 #include "Diagnostics.h"
 #include "Failsafe.h"
 #include "Leds.h"
-
-unsigned long lastLoopMs = 0;
+#include "MotionMixer.h"
+#include "ControlLoop.h"
+#include "Hal.h"
+#include "Log.h"
+#include "Perf.h"
+#include "Latency.h"
+#include "Capture.h"
+#include "BlackBox.h"
+#include "NotchFilter.h"
 
 void setup() {
     Serial.begin(115200);
+    Log_init();
+    Perf_init();
+    Latency_init();
+    Capture_init();
+    BlackBox_init();
 
-    pinMode(PIN_LED_ARM, OUTPUT);
-    digitalWrite(PIN_LED_ARM, LOW);
+    Hal_pinOutput(PIN_LED_ARM);
+    Hal_digitalWrite(PIN_LED_ARM, false);
 
     DebugIO_init();
     Diag_init();
     Drive_init();
+    MotionMixer_init();
     Weapon_init();
     BluetoothComm_init();
     Failsafe_init();
     Leds_init();
 
-    lastLoopMs = millis();
-    Serial.println(F("[DBG] Setup done. Waiting for commands..."));
+    ControlLoop_init();
+    ControlLoop_start();   // Drive/Weapon/Failsafe ab hier nur noch im Steuer-Task
+    LOG_DBG("[DBG] Setup done. Waiting for commands...");
 }
 
+// Kommunikationsseite: Eingaben, Parser, LEDs und Log.
+// Der Steuertakt läuft unabhängig davon im Control-Task (ControlLoop).
 void loop() {
-    unsigned long nowMs = millis();
-    unsigned long dtMs  = nowMs - lastLoopMs;
+    unsigned long nowMs = Hal_millis();
 
-    // Eingaben IMMER erfassen
-    String line;
-    if (BluetoothComm_poll(line, nowMs)) {
-        CommandParser_handleLine(line, nowMs);
+    // Eingaben IMMER erfassen: alle fertigen Zeilen auf einmal
+    LineView lines[COMM_MAX_LINES_PER_POLL];
+    uint32_t rxUs[COMM_MAX_LINES_PER_POLL];
+    uint8_t lineCount;
+    {
+        PERF_SCOPE(PerfId::COMMS_POLL);
+        lineCount = BluetoothComm_poll(lines, rxUs, COMM_MAX_LINES_PER_POLL, nowMs);
+    }
+    if (lineCount > 0) {
+        CommandParser_handleBatch(lines, rxUs, lineCount, nowMs);
     }
 
-    if (dtMs >= LOOP_INTERVAL_MS) {
-        lastLoopMs = nowMs;
+    // Notch-Tabellen, deren Vorgänger der Steuer-Task noch hielt
+    NotchFilter_service();
 
-        Drive_update();
-        Weapon_updateArming(nowMs);
-        Weapon_update(dtMs, nowMs);
-        Failsafe_update(nowMs);
-        Leds_update(nowMs);
-        Diag_update(nowMs);  // periodische Fehlerstatistik
+    {
+        PERF_SCOPE(PerfId::LEDS_UPDATE);
+        Leds_update(nowMs);   // drosselt selbst auf LED_TICK_MS
     }
+
+    // Log-Ausgabe nur in der freien Zeit, nie blockierend
+    Log_drain(LOG_DRAIN_PER_PASS);
 }
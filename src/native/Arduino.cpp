@@ -0,0 +1,45 @@
+#include "Arduino.h"
+
+HardwareSerial Serial;
+
+// --- Print ---
+size_t Print::write(const uint8_t *buf, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*buf++);
+    return n;
+}
+
+size_t Print::print(const char *s) {
+    return write(reinterpret_cast<const uint8_t *>(s), strlen(s));
+}
+
+size_t Print::print(long v, int base) {
+    char buf[40];
+    if (base == 16) snprintf(buf, sizeof(buf), "%lX", v);
+    else            snprintf(buf, sizeof(buf), "%ld", v);
+    return print(buf);
+}
+
+size_t Print::print(unsigned long v, int base) {
+    char buf[40];
+    if (base == 16) snprintf(buf, sizeof(buf), "%lX", v);
+    else            snprintf(buf, sizeof(buf), "%lu", v);
+    return print(buf);
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return print(buf);
+}
+
+// --- HardwareSerial ---
+size_t HardwareSerial::write(uint8_t c) {
+    if (sink_) fputc(c, sink_);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) {
+    if (sink_) fwrite(buf, 1, len, sink_);
+    return len;
+}
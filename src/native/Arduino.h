@@ -0,0 +1,78 @@
+#pragma once
+
+// Minimal Arduino language shim for the [env:native] host build.
+// Only covers what the modules use besides the HAL (Print/Stream, Printable,
+// F(), constrain, isDigit). Hardware access goes through Hal.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len);
+    virtual int availableForWrite() { return 0x7FFFFFFF; }
+
+    size_t print(const char *s);
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(const Printable &x) { return x.printTo(*this); }
+    size_t print(char c)                         { return write(uint8_t(c)); }
+    size_t print(int v, int base = 10)           { return print(long(v), base); }
+    size_t print(unsigned int v, int base = 10)  { return print((unsigned long)v, base); }
+    size_t print(long v, int base = 10);
+    size_t print(unsigned long v, int base = 10);
+    size_t print(double v, int digits = 2);
+
+    size_t println()                                  { return print("\r\n"); }
+    template <typename T> size_t println(const T &v)  { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T &v, int arg) { size_t n = print(v, arg); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+// Console: Serial writes to stdout (or a harness-selected FILE*), never reads.
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long /*baud*/) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+
+    void setSink(FILE *sink) { sink_ = sink; }   // nullptr = discard
+
+private:
+    FILE *sink_ = stdout;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,589 @@
+#include "Bench.h"
+#include <Arduino.h>
+#include "Config.h"
+#include "MotionMixer.h"
+#include "NotchFilter.h"
+#include "WeaponRamp.h"
+#include "MotorDriver.h"
+#include "LedFrame.h"
+#include "LedGamma.h"
+#include "LedEffects.h"
+#include "Hal.h"
+#include "HalSim.h"
+#include <chrono>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock BenchClock;
+
+// Prevents the optimizer from dropping benchmark results
+volatile int g_sink;
+
+double nsPerOp(BenchClock::time_point t0, BenchClock::time_point t1, uint64_t ops) {
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(ops);
+}
+
+// --- mixer: integer MotionMixer vs. the former float path in handleMotion ---
+
+void floatMix(int tSign, int speed, int sSign, int angle, int &outL, int &outR) {
+    float T = float(tSign) * (speed / 99.0f);
+    float S = float(sSign) * (angle / 99.0f);
+    float left = T + S;
+    float right = T - S;
+    if (left > 1.0f) left = 1.0f;
+    if (left < -1.0f) left = -1.0f;
+    if (right > 1.0f) right = 1.0f;
+    if (right < -1.0f) right = -1.0f;
+    outL = int(left * MAX_PWM);
+    outR = int(right * MAX_PWM);
+}
+
+void intMix(int tSign, int speed, int sSign, int angle, int &outL, int &outR) {
+    MotionMixer_mix(tSign * MotionMixer_fromPercent99(uint8_t(speed)),
+                    sSign * MotionMixer_fromPercent99(uint8_t(angle)), outL, outR);
+}
+
+int benchMixer() {
+    MotionMixer_init();
+    const int rounds = 200;
+    const uint64_t ops = uint64_t(rounds) * 2 * 100 * 3 * 100;
+
+    int maxDiff = 0;
+    uint32_t mismatches = 0;
+    for (int ts = -1; ts <= 1; ts += 2)
+        for (int sp = 0; sp < 100; sp++)
+            for (int ss = -1; ss <= 1; ss++)
+                for (int an = 0; an < 100; an++) {
+                    int fl, fr, il, ir;
+                    floatMix(ts, sp, ss, an, fl, fr);
+                    intMix(ts, sp, ss, an, il, ir);
+                    int d = abs(fl - il) > abs(fr - ir) ? abs(fl - il) : abs(fr - ir);
+                    if (d) mismatches++;
+                    if (d > maxDiff) maxDiff = d;
+                }
+
+    BenchClock::time_point t0 = BenchClock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int ts = -1; ts <= 1; ts += 2)
+            for (int sp = 0; sp < 100; sp++)
+                for (int ss = -1; ss <= 1; ss++)
+                    for (int an = 0; an < 100; an++) {
+                        int l, rr;
+                        floatMix(ts, sp, ss, an, l, rr);
+                        g_sink = l + rr;
+                    }
+    BenchClock::time_point t1 = BenchClock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int ts = -1; ts <= 1; ts += 2)
+            for (int sp = 0; sp < 100; sp++)
+                for (int ss = -1; ss <= 1; ss++)
+                    for (int an = 0; an < 100; an++) {
+                        int l, rr;
+                        intMix(ts, sp, ss, an, l, rr);
+                        g_sink = l + rr;
+                    }
+    BenchClock::time_point t2 = BenchClock::now();
+
+    printf("[BENCH] mixer float: %.2f ns/op\n", nsPerOp(t0, t1, ops));
+    printf("[BENCH] mixer int:   %.2f ns/op\n", nsPerOp(t1, t2, ops));
+    printf("[BENCH] mixer diff vs float: %u of %d inputs, max %d LSB (float rounding error near whole PWM steps)\n",
+           mismatches, 2 * 100 * 3 * 100, maxDiff);
+
+    // The Q-format scale must truncate exactly like the division it replaces
+    uint32_t scaleErrors = 0;
+    for (int32_t v = -MIX_FULL_SCALE; v <= MIX_FULL_SCALE; v++) {
+        if (MotionMixer_toPwm(v) != int(v * MAX_PWM / MIX_FULL_SCALE)) scaleErrors++;
+    }
+    printf("[BENCH] mixer Q%d scale vs division: %u errors\n", MIX_PWM_SHIFT, unsigned(scaleErrors));
+    return (maxDiff <= 1 && scaleErrors == 0) ? 0 : 1;
+}
+
+// --- notch: table lookup vs. the former per-call float loop ---
+
+struct RefNotch {
+    int centerUs;
+    int halfWidthUs;
+    float depth;
+};
+
+int floatNotch(const RefNotch *notches, int count, int baseUs, int inputUs) {
+    if (count == 0 || inputUs <= baseUs + 5) return inputUs;
+
+    float delta = float(inputUs - baseUs);
+    float factor = 1.0f;
+    for (int i = 0; i < count; i++) {
+        int d = abs(inputUs - notches[i].centerUs);
+        if (d < notches[i].halfWidthUs) {
+            float w = 1.0f - float(d) / float(notches[i].halfWidthUs);
+            factor *= 1.0f - notches[i].depth * w;
+        }
+    }
+    factor = constrain(factor, 0.0f, 1.0f);
+    int outUs = baseUs + int(delta * factor + 0.5f);
+    return constrain(outUs, ESC_OFF_US, ESC_MAX_US);
+}
+
+int benchNotch() {
+    const RefNotch cfg[MAX_NOTCHES] = {
+        {1200, 40, 0.3f}, {1350, 80, 0.9f}, {1500, 100, 0.7f}, {1530, 60, 0.5f},
+        {1650, 25, 1.0f}, {1780, 120, 0.2f}, {1900, 50, 0.6f}, {1990, 30, 0.4f},
+    };
+    const int rounds = 2000;
+    const uint64_t ops = uint64_t(rounds) * (ESC_MAX_US - ESC_OFF_US + 1);
+
+    uint32_t mismatches = 0;
+    for (int count = 0; count <= MAX_NOTCHES; count += 4) {
+        NotchFilter_init(ESC_ARM_US);
+        NotchFilter_setEnabled(true);
+        for (int i = 0; i < count; i++) {
+            NotchFilter_add(cfg[i].centerUs, cfg[i].halfWidthUs, cfg[i].depth);
+        }
+        // play the control task: acknowledge until every rebuild is published
+        const NotchTable *table = NotchFilter_acquire();
+        while (NotchFilter_service()) table = NotchFilter_acquire();
+        table = NotchFilter_acquire();
+
+        for (int us = ESC_OFF_US; us <= ESC_MAX_US; us++) {
+            if (NotchFilter_apply(table, us, true) != floatNotch(cfg, count, ESC_ARM_US, us)) mismatches++;
+        }
+
+        BenchClock::time_point t0 = BenchClock::now();
+        for (int r = 0; r < rounds; r++)
+            for (int us = ESC_OFF_US; us <= ESC_MAX_US; us++)
+                g_sink = floatNotch(cfg, count, ESC_ARM_US, us);
+        BenchClock::time_point t1 = BenchClock::now();
+        for (int r = 0; r < rounds; r++)
+            for (int us = ESC_OFF_US; us <= ESC_MAX_US; us++)
+                g_sink = NotchFilter_apply(table, us, true);
+        BenchClock::time_point t2 = BenchClock::now();
+
+        printf("[BENCH] notch %d notches: float %.2f ns/op, table %.2f ns/op\n",
+               count, nsPerOp(t0, t1, ops), nsPerOp(t1, t2, ops));
+    }
+
+    printf("[BENCH] notch diff vs float: %u mismatches over %d inputs x 3 configs\n",
+           mismatches, ESC_MAX_US - ESC_OFF_US + 1);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --- ramp: fixed-point WeaponRamp vs. the former truncating float ramp ---
+
+// Ticks until goalUs is reached, 0 = stalled (former Weapon_update step)
+uint32_t floatRampTicks(int fromUs, int goalUs, uint32_t dtUs, uint32_t maxTicks) {
+    float rateUp   = float(ESC_MAX_US - ESC_OFF_US) / float(WEAPON_RAMP_UP_TIME_MS);
+    float rateDown = float(ESC_MAX_US - ESC_OFF_US) / float(WEAPON_RAMP_DOWN_TIME_MS);
+    float dtMs = float(dtUs) * 0.001f;
+    int us = fromUs;
+    for (uint32_t t = 1; t <= maxTicks; t++) {
+        if (us < goalUs) {
+            us += int(rateUp * dtMs);
+            if (us > goalUs) us = goalUs;
+        } else if (us > goalUs) {
+            us -= int(rateDown * dtMs);
+            if (us < goalUs) us = goalUs;
+        }
+        if (us == goalUs) return t;
+    }
+    return 0;
+}
+
+uint32_t fixedRampTicks(int fromUs, int goalUs, uint32_t dtUs, uint32_t maxTicks) {
+    WeaponRamp_rebase(fromUs);
+    for (uint32_t t = 1; t <= maxTicks; t++) {
+        if (WeaponRamp_step(goalUs, dtUs) == goalUs) return t;
+    }
+    return 0;
+}
+
+int benchRamp() {
+    struct RampCase {
+        const char *name;
+        int fromUs;
+        int goalUs;
+    };
+    const RampCase cases[] = {
+        {"OFF->MAX", ESC_OFF_US, ESC_MAX_US},
+        {"ARM->MAX", ESC_ARM_US, ESC_MAX_US},
+        {"MAX->ARM", ESC_MAX_US, ESC_ARM_US},
+    };
+    const uint32_t dts[] = {10000, 1000, 500, 100};
+    const RampProfile profiles[] = {RampProfile::LINEAR, RampProfile::SCURVE, RampProfile::TABLE};
+    const char *const profileNames[] = {"LINEAR", "SCURVE", "TABLE"};
+
+    WeaponRamp_init(ESC_OFF_US);
+    for (uint8_t i = 0; i < RAMP_TABLE_POINTS; i++) {
+        WeaponRamp_setTablePoint(i, uint16_t(i * i * 1000 / 256));   // quadratic
+    }
+
+    uint32_t failures = 0;
+    for (const RampCase &c : cases) {
+        uint32_t rampMs = c.goalUs > c.fromUs ? WEAPON_RAMP_UP_TIME_MS : WEAPON_RAMP_DOWN_TIME_MS;
+        uint32_t dist = uint32_t(abs(c.goalUs - c.fromUs));
+        uint32_t expectUs = uint32_t(uint64_t(dist) * rampMs * 1000ULL / (ESC_MAX_US - ESC_OFF_US));
+
+        for (uint32_t dt : dts) {
+            uint32_t maxTicks = 4 * expectUs / dt + 4;
+            uint32_t legacy = floatRampTicks(c.fromUs, c.goalUs, dt, maxTicks);
+            printf("[BENCH] ramp %s dt=%5uus expect %6.1f ms: float ", c.name, unsigned(dt), expectUs / 1000.0);
+            if (legacy) printf("%6.1f ms", legacy * dt / 1000.0);
+            else        printf("stalled  ");
+
+            for (uint8_t p = 0; p < 3; p++) {
+                WeaponRamp_setProfile(c.goalUs > c.fromUs, profiles[p]);
+                uint32_t ticks = fixedRampTicks(c.fromUs, c.goalUs, dt, maxTicks);
+                uint64_t tookUs = uint64_t(ticks) * dt;
+                bool ok = ticks && tookUs >= expectUs && tookUs - expectUs < dt;
+                if (!ok) failures++;
+                printf(", %s %6.1f ms%s", profileNames[p], tookUs / 1000.0, ok ? "" : " FAIL");
+            }
+            printf("\n");
+        }
+    }
+    WeaponRamp_init(ESC_OFF_US);
+
+    printf("[BENCH] ramp: %u cases outside one tick of the configured time\n", unsigned(failures));
+    return failures == 0 ? 0 : 1;
+}
+
+// --- motor: synchronized MotorDriver vs. the former per-channel writes ---
+
+// Former setLeftMotor/setRightMotor: one Hal_pwmWrite per channel
+void legacyMotor(uint8_t chFwd, uint8_t chRev, int speed) {
+    if (speed > 0) {
+        Hal_pwmWrite(chFwd, uint32_t(speed));
+        Hal_pwmWrite(chRev, 0);
+    } else if (speed < 0) {
+        Hal_pwmWrite(chFwd, 0);
+        Hal_pwmWrite(chRev, uint32_t(-speed));
+    } else {
+        Hal_pwmWrite(chFwd, 0);
+        Hal_pwmWrite(chRev, 0);
+    }
+}
+
+int benchMotor() {
+    const int steps = 200000;
+
+    // Random walk with frequent reversals and repeated targets
+    std::vector<int> left(steps), right(steps);
+    uint32_t rng = 12345;
+    for (int i = 0; i < steps; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int r = int((rng >> 16) % (2 * MAX_PWM + 1)) - MAX_PWM;
+        left[i]  = (rng & 0x3) == 0 && i ? left[i - 1] : r;
+        right[i] = (rng & 0xC) == 0 && i ? right[i - 1] : -r / 2;
+    }
+
+    HalSim_reset();
+    HalSim_watchBridge(MOTOR_CH_IN1, MOTOR_CH_IN2);
+    HalSim_watchBridge(MOTOR_CH_IN3, MOTOR_CH_IN4);
+    BenchClock::time_point t0 = BenchClock::now();
+    for (int i = 0; i < steps; i++) {
+        legacyMotor(MOTOR_CH_IN1, MOTOR_CH_IN2, left[i]);
+        legacyMotor(MOTOR_CH_IN3, MOTOR_CH_IN4, right[i]);
+    }
+    BenchClock::time_point t1 = BenchClock::now();
+    uint32_t legacyViolations = HalSim_bridgeViolations();
+    uint32_t legacyWrites = 0;
+    for (uint8_t ch = 0; ch < 4; ch++) legacyWrites += HalSim_pwmWriteCount(ch);
+
+    HalSim_reset();
+    MotorDriver_init();
+    HalSim_watchBridge(MOTOR_CH_IN1, MOTOR_CH_IN2);
+    HalSim_watchBridge(MOTOR_CH_IN3, MOTOR_CH_IN4);
+    BenchClock::time_point t2 = BenchClock::now();
+    for (int i = 0; i < steps; i++) {
+        MotorDriver_write(left[i], right[i]);
+    }
+    BenchClock::time_point t3 = BenchClock::now();
+    uint32_t violations = HalSim_bridgeViolations();
+
+    uint32_t mismatches = 0;
+    if (HalSim_pwmDuty(MOTOR_CH_IN1) != uint32_t(left[steps - 1] > 0 ? left[steps - 1] : 0)) mismatches++;
+    if (HalSim_pwmDuty(MOTOR_CH_IN2) != uint32_t(left[steps - 1] < 0 ? -left[steps - 1] : 0)) mismatches++;
+    if (HalSim_pwmDuty(MOTOR_CH_IN3) != uint32_t(right[steps - 1] > 0 ? right[steps - 1] : 0)) mismatches++;
+    if (HalSim_pwmDuty(MOTOR_CH_IN4) != uint32_t(right[steps - 1] < 0 ? -right[steps - 1] : 0)) mismatches++;
+
+    printf("[BENCH] motor per-channel: %.2f ns/update, %u channel writes, %u illegal bridge states\n",
+           nsPerOp(t0, t1, steps), unsigned(legacyWrites), unsigned(legacyViolations));
+    printf("[BENCH] motor sync latch:  %.2f ns/update, %u channel writes (%u skipped), %u illegal bridge states\n",
+           nsPerOp(t2, t3, steps), unsigned(MotorDriver_getChannelWrites()),
+           unsigned(MotorDriver_getChannelSkips()), unsigned(violations));
+    HalSim_reset();
+    return (violations == 0 && mismatches == 0) ? 0 : 1;
+}
+
+// --- leds: dirty-span LedFrame vs. rewriting and showing the whole strip every tick ---
+
+const uint16_t kLedSizes[] = {10, 100, 1000};
+const int kLedFrames = 2000;
+
+enum class LedScene { PULSE, AUTO };
+
+uint32_t pulseColor(int frame) {
+    int t = frame % 100;
+    uint32_t level = uint32_t(t < 50 ? t : 100 - t) * 255U / 50U;
+    return level << 8;   // green breathing
+}
+
+// AUTO-like scene: drive zones (outer thirds) with a moving pixel, static
+// weapon zone in the middle
+void autoZones(uint16_t n, uint16_t &leftN, uint16_t &midStart, uint16_t &midN, uint16_t &rightStart) {
+    leftN = n / 3;
+    midStart = leftN;
+    midN = uint16_t(n - 2 * leftN);
+    rightStart = uint16_t(midStart + midN);
+}
+
+uint32_t autoPixel(uint16_t n, int frame, uint16_t i) {
+    uint16_t leftN, midStart, midN, rightStart;
+    autoZones(n, leftN, midStart, midN, rightStart);
+    if (i >= midStart && i < rightStart) return 0xFF8000;
+    uint16_t pos = uint16_t((frame / 3) % leftN);
+    if (i < leftN) return i == pos ? 0x0000FF : 0;
+    return (i - rightStart) == pos ? 0x0000FF : 0;
+}
+
+void legacyLedFrame(LedScene scene, uint16_t n, int frame) {
+    uint32_t pulse = pulseColor(frame);
+    for (uint16_t i = 0; i < n; i++) {
+        Hal_pixelsSet(i, LedGamma_encode(scene == LedScene::PULSE ? pulse : autoPixel(n, frame, i)));
+    }
+    Hal_pixelsShow();
+}
+
+bool ledFrameRender(LedFrame &f, LedScene scene, uint16_t n, int frame) {
+    if (scene == LedScene::PULSE) {
+        f.fill(0, n, pulseColor(frame));
+    } else {
+        uint16_t leftN, midStart, midN, rightStart;
+        autoZones(n, leftN, midStart, midN, rightStart);
+        uint16_t pos = uint16_t((frame / 3) % leftN);
+        f.fill(0, leftN, 0);
+        f.set(pos, 0x0000FF);
+        f.fill(midStart, midN, 0xFF8000);
+        f.fill(rightStart, leftN, 0);
+        f.set(uint16_t(rightStart + pos), 0x0000FF);
+    }
+    if (!f.flush()) return false;
+    Hal_pixelsShow();
+    return true;
+}
+
+uint64_t latchedHash(uint16_t n) {
+    uint64_t h = 1469598103934665603ULL;
+    for (uint16_t i = 0; i < n; i++) h = (h ^ HalSim_pixel(i)) * 1099511628211ULL;
+    return h;
+}
+
+int benchLeds() {
+    const char *const sceneNames[] = {"pulse", "auto"};
+    const uint64_t frameSpacingUs = 40000;   // longer than a 1000-pixel frame on the wire
+    int rc = 0;
+    LedGamma_setBrightness(LED_BRIGHTNESS);
+
+    for (LedScene scene : {LedScene::PULSE, LedScene::AUTO}) {
+        for (uint16_t n : kLedSizes) {
+            std::vector<uint64_t> expected(kLedFrames);
+
+            HalSim_reset();
+            Hal_pixelsBegin(n, 0);
+            double legacyNs = 0;
+            for (int i = 0; i < kLedFrames; i++) {
+                HalSim_setTimeUs(uint64_t(i) * frameSpacingUs);
+                BenchClock::time_point a = BenchClock::now();
+                legacyLedFrame(scene, n, i);
+                legacyNs += std::chrono::duration<double, std::nano>(BenchClock::now() - a).count();
+                expected[i] = latchedHash(n);
+            }
+            uint32_t legacyShows = HalSim_pixelShowCount();
+
+            HalSim_reset();
+            Hal_pixelsBegin(n, 0);
+            std::vector<uint32_t> pixels(n);
+            LedFrame frame(pixels.data(), n);
+            uint32_t mismatches = 0;
+            double renderNs = 0;
+            for (int i = 0; i < kLedFrames; i++) {
+                HalSim_setTimeUs(uint64_t(i) * frameSpacingUs);
+                BenchClock::time_point a = BenchClock::now();
+                ledFrameRender(frame, scene, n, i);
+                renderNs += std::chrono::duration<double, std::nano>(BenchClock::now() - a).count();
+                if (latchedHash(n) != expected[i]) mismatches++;
+            }
+
+            printf("[BENCH] leds %-5s %4u px: full rewrite %9.1f ns/frame, %4u shows | dirty spans %9.1f ns/frame, %4u shows, %u mismatches\n",
+                   sceneNames[int(scene)], unsigned(n), legacyNs / kLedFrames, unsigned(legacyShows),
+                   renderNs / kLedFrames, unsigned(HalSim_pixelShowCount()), unsigned(mismatches));
+            if (mismatches) rc = 1;
+        }
+    }
+    HalSim_reset();
+    return rc;
+}
+
+// --- ledfx: fixed-point PULSE + gamma LUT vs. the former division path, layer blend ---
+
+// Former applyPulse + Adafruit setBrightness scaling, per frame
+uint32_t legacyPulse(uint32_t elapsedMs, uint32_t periodMs, uint32_t color, uint16_t scale) {
+    uint32_t cycle = elapsedMs % periodMs;
+    uint32_t half = periodMs / 2;
+    uint8_t level = cycle < half ? uint8_t(cycle * 510U / periodMs)
+                                 : uint8_t(255U - (cycle - half) * 510U / periodMs);
+    uint8_t r = uint8_t(((color >> 16) & 0xFF) * level / 255);
+    uint8_t g = uint8_t(((color >> 8) & 0xFF) * level / 255);
+    uint8_t b = uint8_t((color & 0xFF) * level / 255);
+    r = uint8_t((r * scale) >> 8);
+    g = uint8_t((g * scale) >> 8);
+    b = uint8_t((b * scale) >> 8);
+    return (uint32_t(r) << 16) | (uint32_t(g) << 8) | b;
+}
+
+uint32_t fixedPulse(const LedPhase &phase, uint32_t color) {
+    uint8_t level = LedFx_triangle(LedPhase_get88(phase));
+    return LedGamma_encode(level ? LedFx_scale(color, level) : 0);
+}
+
+// Reference model of the same definitions, with plain division and
+// floating point: phase from the elapsed time, gamma from pow()
+uint8_t refEncodeChannel(uint32_t v, uint8_t brightness) {
+    double g = floor(65535.0 * pow(v / 255.0, 2.2) + 0.5);
+    return uint8_t(floor(g * brightness / 65535.0 + 0.5));
+}
+
+uint32_t refPulse(uint64_t elapsedMs, uint32_t rate, uint32_t color, uint8_t brightness) {
+    uint32_t phase88 = uint32_t((elapsedMs * rate) % (1ULL << 32) / 65536U);
+    uint32_t level = phase88 < 32768 ? phase88 / 128 : (65535 - phase88) / 128;
+    uint32_t out = 0;
+    for (int shift = 16; shift >= 0; shift -= 8) {
+        uint32_t c = level ? ((color >> shift) & 0xFF) * (level + 1) / 256 : 0;
+        out |= uint32_t(refEncodeChannel(c, brightness)) << shift;
+    }
+    return out;
+}
+
+int benchLedFx() {
+    uint32_t mismatches = 0;
+
+    // Gamma table and LUT for every brightness and level
+    for (uint32_t v = 0; v < 256; v++) {
+        if (LedGamma_curve(uint8_t(v)) != uint16_t(floor(65535.0 * pow(v / 255.0, 2.2) + 0.5))) mismatches++;
+    }
+    for (uint32_t b = 0; b < 256; b++) {
+        LedGamma_setBrightness(uint8_t(b));
+        for (uint32_t v = 0; v < 256; v++) {
+            if ((LedGamma_encode(v) & 0xFF) != refEncodeChannel(v, uint8_t(b))) mismatches++;
+        }
+    }
+
+    // PULSE over jittered ticks: accumulator vs. elapsed-time reference
+    const uint32_t periods[] = {100, 700, 2500, 9900};
+    const uint32_t color = 0x40C0FF;
+    const int frames = 200000;
+    LedGamma_setBrightness(LED_BRIGHTNESS);
+
+    std::vector<uint32_t> dts(frames);
+    uint32_t rng = 777;
+    for (int i = 0; i < frames; i++) {
+        rng = rng * 1103515245u + 12345u;
+        dts[i] = LED_TICK_MS + (rng >> 16) % 5;   // loop() jitter on the 20 ms tick
+    }
+
+    double legacyNs = 0;
+    double fixedNs = 0;
+    for (uint32_t period : periods) {
+        uint32_t elapsed = 0;
+        BenchClock::time_point t0 = BenchClock::now();
+        for (int i = 0; i < frames; i++) {
+            elapsed += dts[i];
+            g_sink = int(legacyPulse(elapsed, period, color, uint16_t(LED_BRIGHTNESS) + 1));
+        }
+        BenchClock::time_point t1 = BenchClock::now();
+
+        LedPhase phase;
+        LedPhase_start(phase, period);
+        BenchClock::time_point t2 = BenchClock::now();
+        for (int i = 0; i < frames; i++) {
+            LedPhase_advance(phase, dts[i]);
+            g_sink = int(fixedPulse(phase, color));
+        }
+        BenchClock::time_point t3 = BenchClock::now();
+        legacyNs += nsPerOp(t0, t1, frames);
+        fixedNs += nsPerOp(t2, t3, frames);
+
+        LedPhase_start(phase, period);
+        uint64_t total = 0;
+        for (int i = 0; i < frames; i++) {
+            LedPhase_advance(phase, dts[i]);
+            total += dts[i];
+            if (fixedPulse(phase, color) != refPulse(total, phase.ratePerMs, color, LED_BRIGHTNESS)) mismatches++;
+            uint16_t count = uint16_t(1 + i % 300);
+            if (LedFx_position(LedPhase_get88(phase), count) != uint32_t(LedPhase_get88(phase)) * count / 65536U) {
+                mismatches++;
+            }
+        }
+    }
+
+    // Layer blend vs. the exact lerp: opaque replaces, transparent keeps,
+    // everything in between within one step per channel
+    const uint8_t layerAlphas[] = {0, 1, 64, 128, 254, 255};
+    double maxBlendErr = 0;
+    for (uint32_t pa = 0; pa < 256; pa++) {
+        for (uint8_t la : layerAlphas) {
+            double eff = pa / 255.0 * la / 255.0;
+            for (uint32_t s = 0; s < 256; s += 5) {
+                for (uint32_t d = 0; d < 256; d += 5) {
+                    uint32_t out = LedFx_blend(d << 8, (pa << 24) | (s << 8), la);
+                    if ((out & 0xFF00FF) != 0) mismatches++;
+                    double err = fabs(double(out >> 8) - (d + (double(s) - d) * eff));
+                    if (err > maxBlendErr) maxBlendErr = err;
+                    if ((eff == 0 && (out >> 8) != d) || (eff == 1 && (out >> 8) != s)) mismatches++;
+                }
+            }
+        }
+    }
+    if (maxBlendErr >= 1.0) mismatches++;
+
+    printf("[BENCH] ledfx pulse division:    %.2f ns/frame\n", legacyNs / 4);
+    printf("[BENCH] ledfx pulse fixed-point: %.2f ns/frame (8.8 phase, gamma+brightness LUT), %u mismatches vs. reference\n",
+           fixedNs / 4, unsigned(mismatches));
+    printf("[BENCH] ledfx layer blend: max error %.2f steps vs. exact lerp\n", maxBlendErr);
+    return mismatches == 0 ? 0 : 1;
+}
+
+struct BenchEntry {
+    const char *name;
+    int (*fn)();
+};
+
+const BenchEntry kBenches[] = {
+    {"mixer", benchMixer},
+    {"notch", benchNotch},
+    {"ramp", benchRamp},
+    {"motor", benchMotor},
+    {"leds", benchLeds},
+    {"ledfx", benchLedFx},
+};
+
+} // namespace
+
+int Bench_run(const char *name) {
+    bool all = strcmp(name, "all") == 0;
+    int rc = 0;
+    bool found = false;
+    for (const BenchEntry &b : kBenches) {
+        if (all || strcmp(name, b.name) == 0) {
+            found = true;
+            int r = b.fn();
+            if (r > rc) rc = r;
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "[BENCH] unknown benchmark '%s'. Available: all", name);
+        for (const BenchEntry &b : kBenches) fprintf(stderr, ", %s", b.name);
+        fprintf(stderr, "\n");
+        return 2;
+    }
+    return rc;
+}
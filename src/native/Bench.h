@@ -0,0 +1,8 @@
+#pragma once
+
+// Host micro-benchmarks, run via "program --bench <name>" (native build only).
+// Each benchmark compares a hot path against its reference implementation
+// and prints timing plus any output mismatch to stdout.
+
+// Returns the process exit code: 0 ok, 1 mismatch, 2 unknown benchmark
+int Bench_run(const char *name);
@@ -0,0 +1,277 @@
+#include "HalSim.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <string.h>
+#include <vector>
+
+constexpr int SIM_MAX_PINS     = 40;   // ESP32 GPIO range
+constexpr int SIM_MAX_CHANNELS = 16;   // LEDC channels
+constexpr int SIM_MAX_TASKS    = 2;
+constexpr int SIM_MAX_BRIDGES  = 4;
+
+struct SimTask {
+    HalTickFn fn;
+    uint64_t periodUs;
+    uint64_t nextUs;
+};
+
+static struct {
+    uint64_t nowUs;
+    HalSimClockFn clock;
+
+    bool pinLevel[SIM_MAX_PINS];
+    uint32_t pwmDuty[SIM_MAX_CHANNELS];
+    uint32_t pwmWrites[SIM_MAX_CHANNELS];
+    uint64_t pwmPeriodUs[SIM_MAX_CHANNELS];   // 0 = not set up
+    uint64_t pwmStartUs[SIM_MAX_CHANNELS];
+
+    uint8_t bridge[SIM_MAX_BRIDGES][2];       // watched H-bridge input channel pairs
+    int bridgeCount;
+    uint32_t bridgeViolations;
+
+    bool dshotActive;
+    uint16_t dshotFrame;
+    uint64_t dshotPeriodUs;                  // frame + pause, rounded up
+    uint64_t dshotStartUs;
+
+    bool traceOutputs;
+    std::vector<HalSimOutputEvent> trace;
+
+    std::deque<uint8_t> rx[int(HalTransport::COUNT)];
+
+    std::vector<uint32_t> pixels;       // working buffer
+    std::vector<uint32_t> latched;      // what the strip shows
+    uint32_t showCount;
+    uint64_t pixelsBusyUntilUs;         // frame on the wire + reset
+
+    SimTask tasks[SIM_MAX_TASKS];
+    int taskCount;
+} sim;
+
+static uint64_t nowUs() {
+    return sim.clock ? sim.clock() : sim.nowUs;
+}
+
+// --- Sim control ---
+void HalSim_reset() {
+    sim.nowUs = 0;
+    sim.clock = nullptr;
+    memset(sim.pinLevel, 0, sizeof(sim.pinLevel));
+    memset(sim.pwmDuty, 0, sizeof(sim.pwmDuty));
+    memset(sim.pwmWrites, 0, sizeof(sim.pwmWrites));
+    memset(sim.pwmPeriodUs, 0, sizeof(sim.pwmPeriodUs));
+    memset(sim.pwmStartUs, 0, sizeof(sim.pwmStartUs));
+    sim.bridgeCount = 0;
+    sim.bridgeViolations = 0;
+    sim.dshotActive = false;
+    sim.dshotFrame = 0;
+    sim.traceOutputs = false;
+    sim.trace.clear();
+    for (auto &q : sim.rx) q.clear();
+    sim.pixels.clear();
+    sim.latched.clear();
+    sim.showCount = 0;
+    sim.pixelsBusyUntilUs = 0;
+    sim.taskCount = 0;
+}
+
+void HalSim_setClock(HalSimClockFn fn) { sim.clock = fn; }
+void HalSim_setTimeUs(uint64_t t)      { sim.nowUs = t; }
+void HalSim_advanceUs(uint64_t d)      { sim.nowUs += d; }
+uint64_t HalSim_timeUs()               { return nowUs(); }
+
+int HalSim_runTasks() {
+    int runs = 0;
+    for (int i = 0; i < sim.taskCount; i++) {
+        SimTask &t = sim.tasks[i];
+        uint64_t now = nowUs();
+        if (now < t.nextUs) continue;
+        uint64_t periods = (now - t.nextUs) / t.periodUs + 1;
+        t.nextUs += periods * t.periodUs;   // fixed release grid, no drift
+        t.fn(uint32_t(periods));
+        runs++;
+    }
+    return runs;
+}
+
+void HalSim_feed(HalTransport t, const char *data, size_t len) {
+    auto &q = sim.rx[int(t)];
+    q.insert(q.end(), data, data + len);
+}
+
+size_t HalSim_pending(HalTransport t) { return sim.rx[int(t)].size(); }
+
+bool HalSim_pinLevel(int pin) {
+    return (pin >= 0 && pin < SIM_MAX_PINS) ? sim.pinLevel[pin] : false;
+}
+
+uint32_t HalSim_pwmDuty(uint8_t ch)       { return ch < SIM_MAX_CHANNELS ? sim.pwmDuty[ch] : 0; }
+uint32_t HalSim_pwmWriteCount(uint8_t ch) { return ch < SIM_MAX_CHANNELS ? sim.pwmWrites[ch] : 0; }
+
+void HalSim_watchBridge(uint8_t chA, uint8_t chB) {
+    if (sim.bridgeCount >= SIM_MAX_BRIDGES || chA >= SIM_MAX_CHANNELS || chB >= SIM_MAX_CHANNELS) return;
+    sim.bridge[sim.bridgeCount][0] = chA;
+    sim.bridge[sim.bridgeCount][1] = chB;
+    sim.bridgeCount++;
+}
+
+uint32_t HalSim_bridgeViolations() { return sim.bridgeViolations; }
+
+// Called after every completed register update, i.e. for each state the
+// outputs can actually take
+static void checkBridges() {
+    for (int i = 0; i < sim.bridgeCount; i++) {
+        if (sim.pwmDuty[sim.bridge[i][0]] != 0 && sim.pwmDuty[sim.bridge[i][1]] != 0) {
+            sim.bridgeViolations++;
+        }
+    }
+}
+uint16_t HalSim_dshotFrame()              { return sim.dshotFrame; }
+
+void HalSim_traceOutputs(bool enabled) { sim.traceOutputs = enabled; }
+const std::vector<HalSimOutputEvent> &HalSim_outputTrace() { return sim.trace; }
+
+// First period/frame boundary at or after now: the update becomes visible there
+static uint64_t nextBoundary(uint64_t startUs, uint64_t periodUs, uint64_t now) {
+    if (periodUs == 0 || now <= startUs) return now;
+    uint64_t k = (now - startUs + periodUs - 1) / periodUs;
+    return startUs + k * periodUs;
+}
+
+static void traceOutput(int16_t channel, uint32_t value, uint64_t emitUs) {
+    if (!sim.traceOutputs) return;
+    HalSimOutputEvent e;
+    e.writeUs = nowUs();
+    e.emitUs = emitUs;
+    e.channel = channel;
+    e.value = value;
+    sim.trace.push_back(e);
+}
+
+uint16_t HalSim_pixelCount()              { return uint16_t(sim.latched.size()); }
+uint32_t HalSim_pixel(uint16_t idx)       { return idx < sim.latched.size() ? sim.latched[idx] : 0; }
+uint32_t HalSim_pixelShowCount()          { return sim.showCount; }
+
+// --- Clock ---
+uint32_t Hal_millis() { return uint32_t(nowUs() / 1000ULL); }
+uint32_t Hal_micros() { return uint32_t(nowUs()); }
+
+// Real host time, independent of the simulated clock
+uint32_t Hal_cycleCount() {
+    return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+uint32_t Hal_cycleFreqMHz() { return 1000; }
+
+// --- Tasks ---
+void Hal_startPeriodicTask(const char * /*name*/, HalTickFn fn, uint32_t periodUs,
+                           uint8_t /*core*/, uint8_t /*priority*/) {
+    if (sim.taskCount >= SIM_MAX_TASKS) return;
+    SimTask &t = sim.tasks[sim.taskCount++];
+    t.fn = fn;
+    t.periodUs = periodUs ? periodUs : 1;
+    t.nextUs = nowUs() + t.periodUs;
+}
+
+// --- GPIO ---
+void Hal_pinOutput(int /*pin*/) {}
+
+void Hal_digitalWrite(int pin, bool high) {
+    if (pin >= 0 && pin < SIM_MAX_PINS) sim.pinLevel[pin] = high;
+}
+
+// --- LEDC / PWM ---
+void Hal_pwmSetup(uint8_t channel, uint32_t freqHz, uint8_t /*resBits*/) {
+    if (channel >= SIM_MAX_CHANNELS || freqHz == 0) return;
+    sim.pwmPeriodUs[channel] = 1000000ULL / freqHz;
+    sim.pwmStartUs[channel] = nowUs();
+}
+
+void Hal_pwmAttach(int /*pin*/, uint8_t /*channel*/) {}
+void Hal_pwmDetach(int /*pin*/) {}
+
+static void storeDuty(uint8_t channel, uint32_t duty) {
+    sim.pwmDuty[channel] = duty;
+    sim.pwmWrites[channel]++;
+    traceOutput(int16_t(channel), duty,
+                nextBoundary(sim.pwmStartUs[channel], sim.pwmPeriodUs[channel], nowUs()));
+}
+
+void Hal_pwmWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= SIM_MAX_CHANNELS) return;
+    storeDuty(channel, duty);
+    checkBridges();
+}
+
+// Like the LEDC start bits, the latches are separate: a period boundary may
+// fall between any two, so every intermediate state is checked
+void Hal_pwmWriteSync(const uint8_t *channels, const uint32_t *duties, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (channels[i] >= SIM_MAX_CHANNELS) continue;
+        storeDuty(channels[i], duties[i]);
+        checkBridges();
+    }
+}
+
+// --- DShot output ---
+bool Hal_dshotBegin(int /*pin*/, uint16_t kbps) {
+    if (kbps == 0) return false;
+    sim.dshotActive = true;
+    sim.dshotFrame = 0;
+    sim.dshotPeriodUs = (16000ULL + kbps - 1) / kbps + 20;   // 16 bits + 20 us pause
+    sim.dshotStartUs = nowUs();
+    return true;
+}
+
+void Hal_dshotWrite(uint16_t frame) {
+    if (!sim.dshotActive) return;
+    sim.dshotFrame = frame;
+    traceOutput(HALSIM_DSHOT_CHANNEL, frame, nextBoundary(sim.dshotStartUs, sim.dshotPeriodUs, nowUs()));
+}
+
+void Hal_dshotEnd(int /*pin*/) { sim.dshotActive = false; }
+
+// --- Serial transports ---
+void Hal_btBegin(const char * /*deviceName*/) {}
+
+int Hal_transportAvailable(HalTransport t) {
+    return int(sim.rx[int(t)].size());
+}
+
+int Hal_transportRead(HalTransport t) {
+    auto &q = sim.rx[int(t)];
+    if (q.empty()) return -1;
+    uint8_t c = q.front();
+    q.pop_front();
+    return c;
+}
+
+// --- Pixel strip ---
+void Hal_pixelsBegin(uint16_t count, int /*pin*/) {
+    sim.pixels.assign(count, 0);
+    sim.latched.assign(count, 0);
+}
+
+bool Hal_pixelsSet(uint16_t idx, uint32_t rgb) {
+    if (idx >= sim.pixels.size()) return false;
+    rgb &= 0xFFFFFF;
+    if (sim.pixels[idx] == rgb) return false;
+    sim.pixels[idx] = rgb;
+    return true;
+}
+
+void Hal_pixelsClear() {
+    std::fill(sim.pixels.begin(), sim.pixels.end(), 0);
+}
+
+// Same timing as the RMT backend: 24 bits of 1.25 us per pixel, then the
+// latch low time; the frame counts as shown when the transfer starts
+bool Hal_pixelsShow() {
+    uint64_t now = nowUs();
+    if (now < sim.pixelsBusyUntilUs) return false;
+    sim.latched = sim.pixels;
+    sim.showCount++;
+    sim.pixelsBusyUntilUs = now + (uint64_t(sim.pixels.size()) * 24U * 125U + 99U) / 100U + 60U;
+    return true;
+}
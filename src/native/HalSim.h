@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Hal.h"
+#include <vector>
+
+// Host-side control of the simulated HAL (native build only).
+// The clock does not move on its own: the harness advances it, or injects
+// its own time source (e.g. a wall clock for real-time runs).
+
+typedef uint64_t (*HalSimClockFn)();
+
+void     HalSim_reset();
+void     HalSim_setClock(HalSimClockFn fn);    // nullptr = manual sim clock
+void     HalSim_setTimeUs(uint64_t nowUs);
+void     HalSim_advanceUs(uint64_t deltaUs);
+uint64_t HalSim_timeUs();
+
+// Runs every task started with Hal_startPeriodicTask whose next release
+// time has passed. Like the timer notification on target, a clock jump over
+// several periods results in one call with periods > 1.
+// The harness calls this before each loop() pass, standing in for the
+// control core. Returns the number of task calls made.
+int HalSim_runTasks();
+
+// Queue bytes as if they had arrived on a transport
+void HalSim_feed(HalTransport t, const char *data, size_t len);
+size_t HalSim_pending(HalTransport t);
+
+// Recorded outputs
+bool     HalSim_pinLevel(int pin);
+uint32_t HalSim_pwmDuty(uint8_t channel);
+uint32_t HalSim_pwmWriteCount(uint8_t channel);
+uint16_t HalSim_dshotFrame();               // last frame written
+
+// H-bridge mock: counts every PWM update after which both inputs of a
+// watched channel pair are driven (shoot-through / unintended brake)
+void     HalSim_watchBridge(uint8_t chA, uint8_t chB);
+uint32_t HalSim_bridgeViolations();
+
+// Output trace: every PWM duty and DShot frame write, with the time the
+// hardware would first emit it (start of the next PWM period / DShot frame).
+constexpr int16_t HALSIM_DSHOT_CHANNEL = -1;
+
+struct HalSimOutputEvent {
+    uint64_t writeUs;
+    uint64_t emitUs;
+    int16_t  channel;    // LEDC channel or HALSIM_DSHOT_CHANNEL
+    uint32_t value;      // duty or DShot frame
+};
+
+void HalSim_traceOutputs(bool enabled);
+const std::vector<HalSimOutputEvent> &HalSim_outputTrace();
+
+uint16_t HalSim_pixelCount();
+uint32_t HalSim_pixel(uint16_t idx);        // as latched by the last show()
+uint32_t HalSim_pixelShowCount();
@@ -0,0 +1,443 @@
+// Host entry point for [env:native]: runs setup()/loop() against the simulated
+// HAL, many times faster than real time.
+//
+//   program [--seconds S] [--step-us U] [--script FILE | --replay FILE] [--realtime] [--quiet]
+//           [--output-trace FILE] [--golden FILE] [--compare FILE]
+//   program --bench <name|all>
+//   program --decode-bb FILE
+//
+// Script lines: "<timeMs> <usb|bt> <command>", '#' starts a comment.
+// "@lr8|@lr16|@ts8|@ts16 <a> <b>" as command sends a binary motion frame.
+// --replay feeds a REC> capture (see Capture.h) at its recorded times; the
+// file may be a raw blob or a serial log containing the dump.
+// --decode-bb writes a BB> black-box dump (see BlackBox.h) as CSV to stdout.
+//
+// Golden trace (--golden writes it, --compare checks against a reference):
+//   "T <us> <ledc0> <ledc1> <ledc2> <ledc3> <weapon ledc> <dshot>" per control tick
+//   "L <us> <rrggbb>..." per LED frame shown
+
+#include <Arduino.h>
+#include "HalSim.h"
+#include "BinaryProtocol.h"
+#include "Config.h"
+#include "Bench.h"
+#include "ControlLoop.h"
+#include "MotorDriver.h"
+#include "Capture.h"
+#include "BlackBox.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+void setup();
+void loop();
+
+namespace {
+
+struct ScriptEntry {
+    uint64_t atUs;
+    HalTransport transport;
+    std::string text;
+};
+
+struct Options {
+    double seconds = 10.0;
+    uint32_t stepUs = 1000;
+    const char *scriptPath = nullptr;
+    bool realtime = false;
+    bool quiet = false;
+    const char *bench = nullptr;
+    const char *outputTracePath = nullptr;
+    const char *replayPath = nullptr;
+    const char *goldenPath = nullptr;
+    const char *comparePath = nullptr;
+    const char *decodeBbPath = nullptr;
+    bool secondsSet = false;
+};
+
+typedef std::chrono::steady_clock WallClock;
+WallClock::time_point g_wallStart;
+
+uint64_t wallClockUs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+        WallClock::now() - g_wallStart).count());
+}
+
+bool parseArgs(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (a == "--seconds" && hasValue)      { opt.seconds = atof(argv[++i]); opt.secondsSet = true; }
+        else if (a == "--step-us" && hasValue) opt.stepUs = uint32_t(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--script" && hasValue)  opt.scriptPath = argv[++i];
+        else if (a == "--realtime")            opt.realtime = true;
+        else if (a == "--quiet")               opt.quiet = true;
+        else if (a == "--bench" && hasValue)   opt.bench = argv[++i];
+        else if (a == "--output-trace" && hasValue) opt.outputTracePath = argv[++i];
+        else if (a == "--replay" && hasValue)  opt.replayPath = argv[++i];
+        else if (a == "--golden" && hasValue)  opt.goldenPath = argv[++i];
+        else if (a == "--compare" && hasValue) opt.comparePath = argv[++i];
+        else if (a == "--decode-bb" && hasValue) opt.decodeBbPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--seconds S] [--step-us U] [--script FILE | --replay FILE] [--realtime] [--quiet] "
+                            "[--output-trace FILE] [--golden FILE] [--compare FILE] | --bench <name|all> "
+                            "| --decode-bb FILE\n", argv[0]);
+            return false;
+        }
+    }
+    if (opt.scriptPath && opt.replayPath) {
+        fprintf(stderr, "[SIM] --script and --replay are exclusive\n");
+        return false;
+    }
+    if (opt.stepUs == 0) opt.stepUs = 1;
+    return true;
+}
+
+bool encodeBinary(const char *cmd, std::string &out) {
+    static uint8_t seq = 0;
+    char kind[8];
+    int a, b;
+    if (sscanf(cmd, "@%7s %d %d", kind, &a, &b) != 3) return false;
+
+    BinMsgType type;
+    if (strcmp(kind, "lr8") == 0)       type = BinMsgType::MOTION_LR8;
+    else if (strcmp(kind, "lr16") == 0) type = BinMsgType::MOTION_LR16;
+    else if (strcmp(kind, "ts8") == 0)  type = BinMsgType::MOTION_TS8;
+    else if (strcmp(kind, "ts16") == 0) type = BinMsgType::MOTION_TS16;
+    else return false;
+
+    uint8_t frame[BIN_MAX_FRAME_LEN];
+    uint8_t len = BinProto_encode(type, seq++, a, b, frame);
+    out.assign(reinterpret_cast<const char *>(frame), len);
+    return len > 0;
+}
+
+bool loadScript(const char *path, std::vector<ScriptEntry> &out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[SIM] cannot open script %s\n", path);
+        return false;
+    }
+    char buf[256];
+    while (fgets(buf, sizeof(buf), f)) {
+        if (buf[0] == '#' || buf[0] == '\n') continue;
+        unsigned long ms;
+        char src[8];
+        char cmd[200];
+        if (sscanf(buf, "%lu %7s %199[^\r\n]", &ms, src, cmd) != 3) continue;
+        ScriptEntry e;
+        e.atUs = uint64_t(ms) * 1000ULL;
+        e.transport = (strcmp(src, "usb") == 0) ? HalTransport::USB : HalTransport::BT;
+        if (cmd[0] == '@') {
+            if (!encodeBinary(cmd, e.text)) {
+                fprintf(stderr, "[SIM] bad binary command: %s\n", cmd);
+                continue;
+            }
+        } else {
+            e.text = std::string(cmd) + "\n";
+        }
+        out.push_back(e);
+    }
+    fclose(f);
+    return true;
+}
+
+bool readLeb(const std::string &blob, size_t &pos, uint32_t &out) {
+    out = 0;
+    for (uint8_t shift = 0; shift < 35 && pos < blob.size(); shift += 7) {
+        uint8_t b = uint8_t(blob[pos++]);
+        out |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint32_t readLe32(const std::string &blob, size_t pos) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | uint8_t(blob[pos + i]);
+    return v;
+}
+
+uint16_t readLe16(const std::string &blob, size_t pos) {
+    return uint16_t(uint8_t(blob[pos]) | (uint8_t(blob[pos + 1]) << 8));
+}
+
+// Blob of the last "<tag> BEGIN <n>" dump in a serial log, or the whole file
+// if it holds no dump (raw blob)
+bool loadDump(const char *path, const char *tag, std::string &blob) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[SIM] cannot open %s\n", path);
+        return false;
+    }
+    std::string file;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) file.append(buf, n);
+    fclose(f);
+
+    std::string marker = std::string(tag) + " BEGIN ";
+    size_t begin = file.rfind(marker);
+    if (begin != std::string::npos) {
+        size_t eol = file.find("\r\n", begin);
+        unsigned long len = strtoul(file.c_str() + begin + marker.size(), nullptr, 10);
+        if (eol != std::string::npos && eol + 2 + len <= file.size()) blob = file.substr(eol + 2, len);
+    } else {
+        blob = file;
+    }
+    return true;
+}
+
+// Capture blob (or serial log containing "[REC] BEGIN <n>") -> script entries
+bool loadReplay(const char *path, std::vector<ScriptEntry> &out) {
+    std::string blob;
+    if (!loadDump(path, "[REC]", blob)) return false;
+    if (blob.size() < CAPTURE_HEADER_LEN || blob.compare(0, 4, "BBRC") != 0 || uint8_t(blob[4]) != CAPTURE_VERSION) {
+        fprintf(stderr, "[SIM] %s: no capture (version %u) found\n", path, unsigned(CAPTURE_VERSION));
+        return false;
+    }
+
+    uint32_t count = readLe32(blob, 5);
+    size_t end = CAPTURE_HEADER_LEN + readLe32(blob, 9);
+    size_t pos = CAPTURE_HEADER_LEN;
+    uint64_t atUs = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t delayUs, len;
+        if (!readLeb(blob, pos, delayUs) || !readLeb(blob, pos, len) || pos + len > end || end > blob.size()) {
+            fprintf(stderr, "[SIM] %s: capture truncated at line %u\n", path, unsigned(i));
+            return false;
+        }
+        atUs += delayUs;
+        ScriptEntry e;
+        e.atUs = atUs;
+        e.transport = HalTransport::USB;
+        e.text = blob.substr(pos, len);
+        if (len == 0 || uint8_t(e.text[0]) != BIN_SYNC) e.text += "\n";
+        pos += len;
+        out.push_back(e);
+    }
+    return true;
+}
+
+// Black-box blob (or serial log containing "[BB] BEGIN <n>") -> CSV on stdout
+int decodeBlackBox(const char *path) {
+    std::string blob;
+    if (!loadDump(path, "[BB]", blob)) return 1;
+    if (blob.size() < BLACKBOX_HEADER_LEN || blob.compare(0, 4, "BBBX") != 0 ||
+        uint8_t(blob[4]) != BLACKBOX_VERSION || uint8_t(blob[5]) != sizeof(BlackBoxSample)) {
+        fprintf(stderr, "[SIM] %s: no black-box dump (version %u) found\n", path, unsigned(BLACKBOX_VERSION));
+        return 1;
+    }
+
+    static const char *const reasons[] = {"none", "failsafe", "command"};
+    uint8_t reason = uint8_t(blob[6]);
+    uint32_t count = readLe32(blob, 8);
+    if (BLACKBOX_HEADER_LEN + size_t(count) * sizeof(BlackBoxSample) > blob.size()) {
+        fprintf(stderr, "[SIM] %s: black-box dump truncated\n", path);
+        return 1;
+    }
+
+    printf("# samples=%u reason=%s\n", unsigned(count), reason < 3 ? reasons[reason] : "?");
+    printf("t_us,drive_left,drive_right,weapon_us,weapon_target_us,notch_out_us,tick_us,weapon_state,link_timeout\n");
+    size_t pos = BLACKBOX_HEADER_LEN;
+    for (uint32_t i = 0; i < count; i++, pos += sizeof(BlackBoxSample)) {
+        printf("%u,%d,%d,%u,%u,%u,%u,%u,%u\n",
+               unsigned(readLe32(blob, pos)), int(int16_t(readLe16(blob, pos + 4))), int(int16_t(readLe16(blob, pos + 6))),
+               unsigned(readLe16(blob, pos + 8)), unsigned(readLe16(blob, pos + 10)), unsigned(readLe16(blob, pos + 12)),
+               unsigned(readLe16(blob, pos + 14)), unsigned(uint8_t(blob[pos + 16])),
+               unsigned(uint8_t(blob[pos + 17]) & BB_FLAG_LINK_TIMEOUT ? 1 : 0));
+    }
+    return 0;
+}
+
+// Writes the golden trace and/or compares it line by line with a reference
+class GoldenTrace {
+public:
+    bool open(const char *outPath, const char *refPath) {
+        if (outPath && !(out_ = fopen(outPath, "w"))) {
+            fprintf(stderr, "[SIM] cannot write golden trace %s\n", outPath);
+            return false;
+        }
+        if (refPath && !(ref_ = fopen(refPath, "r"))) {
+            fprintf(stderr, "[SIM] cannot open reference %s\n", refPath);
+            return false;
+        }
+        return true;
+    }
+
+    bool active() const { return out_ || ref_; }
+
+    void emit(const std::string &line) {
+        lines_++;
+        if (out_) fprintf(out_, "%s\n", line.c_str());
+        if (!ref_ || mismatchLine_) return;
+        char buf[1024];
+        std::string expected = fgets(buf, sizeof(buf), ref_) ? std::string(buf) : std::string("<end of file>");
+        while (!expected.empty() && (expected.back() == '\n' || expected.back() == '\r')) expected.pop_back();
+        if (expected != line) {
+            mismatchLine_ = lines_;
+            expected_ = expected;
+            actual_ = line;
+        }
+    }
+
+    // 0 = identical (or nothing to compare)
+    int finish() {
+        if (out_) fclose(out_);
+        if (!ref_) return 0;
+        char buf[8];
+        if (!mismatchLine_ && fgets(buf, sizeof(buf), ref_)) {
+            mismatchLine_ = lines_ + 1;
+            expected_ = "<more lines>";
+            actual_ = "<end of trace>";
+        }
+        fclose(ref_);
+        if (!mismatchLine_) {
+            fprintf(stderr, "[SIM] golden trace matches (%llu lines)\n", (unsigned long long)lines_);
+            return 0;
+        }
+        fprintf(stderr, "[SIM] golden trace differs at line %llu\n  expected: %s\n  actual:   %s\n",
+                (unsigned long long)mismatchLine_, expected_.c_str(), actual_.c_str());
+        return 1;
+    }
+
+private:
+    FILE *out_ = nullptr;
+    FILE *ref_ = nullptr;
+    uint64_t lines_ = 0;
+    uint64_t mismatchLine_ = 0;
+    std::string expected_;
+    std::string actual_;
+};
+
+void traceTick(GoldenTrace &golden) {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "T %llu %u %u %u %u %u %u", (unsigned long long)HalSim_timeUs(),
+             unsigned(HalSim_pwmDuty(MOTOR_CH_IN1)), unsigned(HalSim_pwmDuty(MOTOR_CH_IN2)),
+             unsigned(HalSim_pwmDuty(MOTOR_CH_IN3)), unsigned(HalSim_pwmDuty(MOTOR_CH_IN4)),
+             unsigned(HalSim_pwmDuty(WEAPON_CHANNEL)), unsigned(HalSim_dshotFrame()));
+    golden.emit(buf);
+}
+
+void traceLedFrame(GoldenTrace &golden) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "L %llu", (unsigned long long)HalSim_timeUs());
+    std::string line = buf;
+    for (uint16_t i = 0; i < HalSim_pixelCount(); i++) {
+        snprintf(buf, sizeof(buf), " %06X", unsigned(HalSim_pixel(i) & 0xFFFFFF));
+        line += buf;
+    }
+    golden.emit(line);
+}
+
+// CSV: one row per PWM duty / DShot frame write
+bool writeOutputTrace(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "[SIM] cannot write output trace %s\n", path);
+        return false;
+    }
+    fprintf(f, "write_us,emit_us,channel,value\n");
+    for (const HalSimOutputEvent &e : HalSim_outputTrace()) {
+        fprintf(f, "%llu,%llu,%s%d,%u\n", (unsigned long long)e.writeUs, (unsigned long long)e.emitUs,
+                e.channel == HALSIM_DSHOT_CHANNEL ? "dshot" : "ledc", e.channel == HALSIM_DSHOT_CHANNEL ? 0 : e.channel,
+                unsigned(e.value));
+    }
+    fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+    if (opt.bench) return Bench_run(opt.bench);
+    if (opt.decodeBbPath) return decodeBlackBox(opt.decodeBbPath);
+
+    std::vector<ScriptEntry> script;
+    if (opt.scriptPath && !loadScript(opt.scriptPath, script)) return 1;
+    if (opt.replayPath && !loadReplay(opt.replayPath, script)) return 1;
+    if (opt.replayPath && !opt.secondsSet) {
+        opt.seconds = (script.empty() ? 0.0 : double(script.back().atUs) / 1e6) + 1.0;   // 1 s to settle
+    }
+
+    GoldenTrace golden;
+    if (!golden.open(opt.goldenPath, opt.comparePath)) return 1;
+
+    HalSim_reset();
+    g_wallStart = WallClock::now();
+    if (opt.realtime) HalSim_setClock(wallClockUs);
+    if (opt.quiet) Serial.setSink(nullptr);
+    if (opt.outputTracePath) HalSim_traceOutputs(true);
+
+    const uint64_t endUs = uint64_t(opt.seconds * 1e6);
+    size_t nextScript = 0;
+
+    setup();
+    HalSim_watchBridge(MOTOR_CH_IN1, MOTOR_CH_IN2);
+    HalSim_watchBridge(MOTOR_CH_IN3, MOTOR_CH_IN4);
+
+    uint64_t iterations = 0;
+    uint64_t costSumNs = 0;
+    uint64_t costMinNs = UINT64_MAX;
+    uint64_t costMaxNs = 0;
+    WallClock::time_point runStart = WallClock::now();
+
+    while (HalSim_timeUs() < endUs) {
+        while (nextScript < script.size() && script[nextScript].atUs <= HalSim_timeUs()) {
+            const ScriptEntry &e = script[nextScript++];
+            HalSim_feed(e.transport, e.text.data(), e.text.size());
+        }
+
+        // control task, released at its fixed period
+        if (HalSim_runTasks() > 0 && golden.active()) traceTick(golden);
+
+        uint32_t shows = HalSim_pixelShowCount();
+        WallClock::time_point t0 = WallClock::now();
+        loop();
+        uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            WallClock::now() - t0).count());
+        if (golden.active() && HalSim_pixelShowCount() != shows) traceLedFrame(golden);
+
+        iterations++;
+        costSumNs += ns;
+        if (ns < costMinNs) costMinNs = ns;
+        if (ns > costMaxNs) costMaxNs = ns;
+
+        if (!opt.realtime) HalSim_advanceUs(opt.stepUs);
+    }
+
+    double wallS = std::chrono::duration<double>(WallClock::now() - runStart).count();
+    double simS  = double(HalSim_timeUs()) / 1e6;
+
+    fprintf(stderr, "[SIM] iterations=%llu sim=%.3fs wall=%.3fs speedup=%.1fx\n",
+            (unsigned long long)iterations, simS, wallS, wallS > 0.0 ? simS / wallS : 0.0);
+    fprintf(stderr, "[SIM] loop() cost ns: min=%llu avg=%llu max=%llu\n",
+            (unsigned long long)(iterations ? costMinNs : 0),
+            (unsigned long long)(iterations ? costSumNs / iterations : 0),
+            (unsigned long long)costMaxNs);
+
+    ControlLoopStats ct;
+    ControlLoop_getStats(ct);
+    fprintf(stderr, "[SIM] control ticks=%u period=%u..%uus jitter avg=%uus max=%uus missed=%u\n",
+            unsigned(ct.ticks), unsigned(ct.periodMinUs), unsigned(ct.periodMaxUs),
+            unsigned(ct.jitterAvgUs), unsigned(ct.jitterMaxUs), unsigned(ct.missedDeadlines));
+    fprintf(stderr, "[SIM] motor channel writes=%u skipped=%u illegal H-bridge states=%u\n",
+            unsigned(MotorDriver_getChannelWrites()), unsigned(MotorDriver_getChannelSkips()),
+            unsigned(HalSim_bridgeViolations()));
+
+    if (opt.replayPath) {
+        fprintf(stderr, "[SIM] replay: %u lines, %.3f sim-s in %.3f wall-s = %.1f sim-s per wall-s\n",
+                unsigned(script.size()), simS, wallS, wallS > 0.0 ? simS / wallS : 0.0);
+    }
+
+    if (golden.finish() != 0) return 1;
+
+    if (opt.outputTracePath) {
+        if (!writeOutputTrace(opt.outputTracePath)) return 1;
+        fprintf(stderr, "[SIM] output trace: %u writes -> %s\n",
+                unsigned(HalSim_outputTrace().size()), opt.outputTracePath);
+    }
+    return 0;
+}